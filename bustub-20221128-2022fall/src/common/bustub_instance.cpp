@@ -1,3 +1,4 @@
+#include <chrono>  // NOLINT
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -38,7 +39,15 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  auto num_workers = GetExecutionThreads();
+  auto *worker_pool = execution_engine_->GetWorkerPool();
+  worker_pool->Reserve(num_workers);
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_,
+                                                    worker_pool, num_workers);
+  exec_ctx->SetSortMemoryBudget(GetSortMemoryBudget());
+  exec_ctx->SetNLJBlockPages(GetNLJBlockPages());
+  exec_ctx->SetPushExecution(IsPushExecution());
+  return exec_ctx;
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -288,7 +297,7 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         }
 
         // Print optimizer result.
-        bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+        bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(), GetRadixJoinBuildRows());
         auto optimized_plan = optimizer.Optimize(planner.plan_);
 
         l.unlock();
@@ -300,6 +309,25 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
           output += "\n";
         }
 
+        // Run the query, and print the plan with what its executors did.
+        if ((explain_stmt.options_ & ExplainOptions::ANALYZE) != 0) {
+          auto exec_ctx = MakeExecutorContext(txn);
+          std::vector<Tuple> result_set{};
+          auto start = std::chrono::steady_clock::now();
+          is_successful &= execution_engine_->Execute(optimized_plan, &result_set, txn, exec_ctx.get());
+          auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+          output += "=== ANALYZE ===";
+          output += "\n";
+          output += optimized_plan->ToString(show_schema);
+          output += "\n";
+          output += fmt::format("rows={}, time={:.3f}ms", result_set.size(), elapsed);
+          output += "\n";
+          for (const auto &[scan, filter] : exec_ctx->GetUsedBloomFilters()) {
+            output += filter->ToString();
+            output += "\n";
+          }
+        }
+
         WriteOneCell(output, writer);
 
         continue;
@@ -315,7 +343,7 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     planner.PlanQuery(*statement);
 
     // Optimize the query.
-    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(), GetRadixJoinBuildRows());
     auto optimized_plan = optimizer.Optimize(planner.plan_);
 
     l.unlock();
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -17,6 +18,7 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "container/disk/hash/linear_probe_hash_table.h"
 
@@ -26,21 +28,197 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate header page for linear probe hash table");
+  }
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header_page->SetPageId(header_page_id_);
+  size_t num_blocks = std::max<size_t>(1, (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE);
+  CreateNewBlockPages(header_page, std::min(num_blocks, HashTableHeaderPage::MaxNumBlocks()));
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Hash(const KeyType &key) -> uint64_t {
+  return hash_fn_.GetHash(key);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage * {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetBlockPage(Page *page) -> HASH_TABLE_BLOCK_TYPE * {
+  return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate block page for linear probe hash table");
+    }
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  header_page->SetSize(header_page->NumBlocks() * BLOCK_ARRAY_SIZE);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteBlockPages(HashTableHeaderPage *old_header_page) {
+  for (size_t i = 0; i < old_header_page->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(old_header_page->GetBlockPageId(i));
+  }
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  GetValueLatchFree(header_page, key, result);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  if (new_header_page_id_ != INVALID_PAGE_ID) {
+    // Entries of a block being migrated show up in the new layout before they disappear from the old one, so they
+    // may have been seen twice.
+    std::vector<ValueType> migrated;
+    auto *new_header_page = GetHeaderPage(new_header_page_id_);
+    GetValueLatchFree(new_header_page, key, &migrated);
+    buffer_pool_manager_->UnpinPage(new_header_page_id_, false);
+    for (const auto &value : migrated) {
+      if (std::find(result->begin(), result->end(), value) == result->end()) {
+        result->push_back(value);
+      }
+    }
+  }
+  table_latch_.RUnlock();
+  return !result->empty();
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetValueLatchFree(HashTableHeaderPage *header_page, const KeyType &key,
+                                        std::vector<ValueType> *result) -> bool {
+  size_t num_slots = header_page->GetSize();
+  size_t slot = Hash(key) % num_slots;
+  bool found = false;
+  bool reached_empty = false;
+  for (size_t probed = 0; probed < num_slots && !reached_empty;) {
+    page_id_t block_page_id = header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    page->RLatch();
+    auto *block_page = GetBlockPage(page);
+    for (auto offset = slot % BLOCK_ARRAY_SIZE; offset < BLOCK_ARRAY_SIZE && probed < num_slots; offset++, probed++) {
+      if (!block_page->IsOccupied(offset)) {
+        reached_empty = true;
+        break;
+      }
+      if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0) {
+        result->push_back(block_page->ValueAt(offset));
+        found = true;
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    slot = (slot / BLOCK_ARRAY_SIZE + 1) * BLOCK_ARRAY_SIZE % num_slots;
+  }
+  return found;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  MigrateStep(LINEAR_PROBE_MIGRATE_BLOCKS);
+
+  table_latch_.RLock();
+  if (new_header_page_id_ != INVALID_PAGE_ID) {
+    // The pair may still live in the old layout.
+    std::vector<ValueType> old_values;
+    auto *old_header_page = GetHeaderPage(header_page_id_);
+    GetValueLatchFree(old_header_page, key, &old_values);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    if (std::find(old_values.begin(), old_values.end(), value) != old_values.end()) {
+      table_latch_.RUnlock();
+      return false;
+    }
+  }
+
+  page_id_t target_page_id = new_header_page_id_ == INVALID_PAGE_ID ? header_page_id_ : new_header_page_id_;
+  auto *header_page = GetHeaderPage(target_page_id);
+  size_t size = header_page->GetSize();
+  bool is_full = false;
+  bool inserted = ResizeInsert(header_page, key, value, &is_full);
+  buffer_pool_manager_->UnpinPage(target_page_id, false);
+  table_latch_.RUnlock();
+
+  if (is_full) {
+    // Make room synchronously: drain any migration in flight, grow, and move everything over before retrying.
+    while (IsResizing()) {
+      MigrateStep(SIZE_MAX);
+    }
+    if (GetSize() == size) {
+      Resize(size);
+      if (!IsResizing()) {
+        return false;
+      }
+    }
+    while (IsResizing()) {
+      MigrateStep(SIZE_MAX);
+    }
+    return Insert(transaction, key, value);
+  }
+
+  if (inserted && num_occupied_.load() >= static_cast<size_t>(static_cast<double>(size) * LINEAR_PROBE_MAX_LOAD) &&
+      size / BLOCK_ARRAY_SIZE < HashTableHeaderPage::MaxNumBlocks()) {
+    Resize(size);
+  }
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value,
+                                   bool *is_full) -> bool {
+  size_t num_slots = header_page->GetSize();
+  size_t slot = Hash(key) % num_slots;
+  bool inserted = false;
+  bool done = false;
+  for (size_t probed = 0; probed < num_slots && !done;) {
+    page_id_t block_page_id = header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    page->WLatch();
+    auto *block_page = GetBlockPage(page);
+    for (auto offset = slot % BLOCK_ARRAY_SIZE; offset < BLOCK_ARRAY_SIZE && probed < num_slots; offset++, probed++) {
+      if (!block_page->IsOccupied(offset)) {
+        inserted = block_page->Insert(offset, key, value);
+        done = true;
+        break;
+      }
+      if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
+          block_page->ValueAt(offset) == value) {
+        done = true;
+        break;
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, inserted);
+    slot = (slot / BLOCK_ARRAY_SIZE + 1) * BLOCK_ARRAY_SIZE % num_slots;
+  }
+  if (inserted) {
+    num_occupied_++;
+  }
+  *is_full = !done;
+  return inserted;
 }
 
 /*****************************************************************************
@@ -48,21 +226,168 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  MigrateStep(LINEAR_PROBE_MIGRATE_BLOCKS);
+
+  table_latch_.RLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  bool removed = RemoveFrom(header_page, key, value);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  // Checked after the old layout: a pair being migrated is already in the new layout by the time it leaves the old.
+  if (!removed && new_header_page_id_ != INVALID_PAGE_ID) {
+    auto *new_header_page = GetHeaderPage(new_header_page_id_);
+    removed = RemoveFrom(new_header_page, key, value);
+    buffer_pool_manager_->UnpinPage(new_header_page_id_, false);
+  }
+  table_latch_.RUnlock();
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RemoveFrom(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value)
+    -> bool {
+  size_t num_slots = header_page->GetSize();
+  size_t slot = Hash(key) % num_slots;
+  bool removed = false;
+  bool reached_empty = false;
+  for (size_t probed = 0; probed < num_slots && !removed && !reached_empty;) {
+    page_id_t block_page_id = header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    page->WLatch();
+    auto *block_page = GetBlockPage(page);
+    for (auto offset = slot % BLOCK_ARRAY_SIZE; offset < BLOCK_ARRAY_SIZE && probed < num_slots; offset++, probed++) {
+      if (!block_page->IsOccupied(offset)) {
+        reached_empty = true;
+        break;
+      }
+      if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
+          block_page->ValueAt(offset) == value) {
+        block_page->Remove(offset);
+        removed = true;
+        break;
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, removed);
+    slot = (slot / BLOCK_ARRAY_SIZE + 1) * BLOCK_ARRAY_SIZE % num_slots;
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t num_blocks = header_page->NumBlocks();
+  size_t size = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  size_t new_num_blocks = std::min((2 * initial_size + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE,
+                                   HashTableHeaderPage::MaxNumBlocks());
+  if (new_header_page_id_ != INVALID_PAGE_ID || size >= 2 * initial_size || new_num_blocks <= num_blocks) {
+    table_latch_.WUnlock();
+    return;
+  }
+
+  page_id_t new_header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&new_header_page_id);
+  if (page == nullptr) {
+    table_latch_.WUnlock();
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate header page for linear probe hash table");
+  }
+  auto *new_header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  new_header_page->SetPageId(new_header_page_id);
+  CreateNewBlockPages(new_header_page, new_num_blocks);
+  buffer_pool_manager_->UnpinPage(new_header_page_id, true);
+
+  new_header_page_id_ = new_header_page_id;
+  next_migrate_block_ = 0;
+  migrated_blocks_ = 0;
+  num_occupied_ = 0;
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsResizing() -> bool {
+  table_latch_.RLock();
+  bool resizing = new_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateStep(size_t max_blocks) {
+  bool finished = false;
+  table_latch_.RLock();
+  if (new_header_page_id_ != INVALID_PAGE_ID) {
+    auto *old_header_page = GetHeaderPage(header_page_id_);
+    auto *new_header_page = GetHeaderPage(new_header_page_id_);
+    size_t num_blocks = old_header_page->NumBlocks();
+    for (size_t i = 0; i < max_blocks; i++) {
+      size_t block_index = next_migrate_block_++;
+      if (block_index >= num_blocks) {
+        break;
+      }
+      MigrateBlock(old_header_page, new_header_page, block_index);
+      finished = ++migrated_blocks_ == num_blocks;
+    }
+    buffer_pool_manager_->UnpinPage(new_header_page_id_, false);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  }
+  table_latch_.RUnlock();
+
+  // Exactly one operation moves the last block, and that one retires the old layout.
+  if (finished) {
+    FinishResize();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateBlock(HashTableHeaderPage *old_header_page, HashTableHeaderPage *new_header_page,
+                                   size_t block_index) {
+  page_id_t block_page_id = old_header_page->GetBlockPageId(block_index);
+  Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+  // Latch order is always old layout before new layout, so this cannot deadlock with inserts into the new layout.
+  page->WLatch();
+  auto *block_page = GetBlockPage(page);
+  for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; offset++) {
+    if (!block_page->IsReadable(offset)) {
+      continue;
+    }
+    bool is_full = false;
+    ResizeInsert(new_header_page, block_page->KeyAt(offset), block_page->ValueAt(offset), &is_full);
+    BUSTUB_ASSERT(!is_full, "new layout must have room for every migrated entry");
+    block_page->Remove(offset);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishResize() {
+  table_latch_.WLock();
+  auto *old_header_page = GetHeaderPage(header_page_id_);
+  DeleteBlockPages(old_header_page);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->DeletePage(header_page_id_);
+  header_page_id_ = new_header_page_id_;
+  new_header_page_id_ = INVALID_PAGE_ID;
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  page_id_t target_page_id = new_header_page_id_ == INVALID_PAGE_ID ? header_page_id_ : new_header_page_id_;
+  size_t size = GetHeaderPage(target_page_id)->GetSize();
+  buffer_pool_manager_->UnpinPage(target_page_id, false);
+  table_latch_.RUnlock();
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
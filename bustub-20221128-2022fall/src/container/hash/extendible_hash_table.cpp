@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <utility>
 
@@ -23,7 +24,10 @@ namespace bustub {
 
 template <typename K, typename V>
 ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
-    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {dir_.push_back(std::make_shared<Bucket>(bucket_size, 0));}
+    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1), dir_(1) {
+  buckets_.push_back(std::make_unique<Bucket>(bucket_size, 0));
+  dir_[0] = buckets_.back().get();
+}
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
@@ -33,7 +37,7 @@ auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return GetGlobalDepthInternal();
 }
 
@@ -44,18 +48,20 @@ auto ExtendibleHashTable<K, V>::GetGlobalDepthInternal() const -> int {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return GetLocalDepthInternal(dir_index);
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetLocalDepthInternal(int dir_index) const -> int {
-  return dir_[dir_index]->GetDepth();
+  Bucket *bucket = dir_[dir_index].load();
+  std::shared_lock<std::shared_mutex> bucket_lock(bucket->GetLatch());
+  return bucket->GetDepth();
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return GetNumBucketsInternal();
 }
 
@@ -63,6 +69,28 @@ template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
   return num_buckets_;
 }
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::LatchBucket(const K &key, bool exclusive) -> Bucket * {
+  while (true) {
+    Bucket *bucket = dir_[IndexOf(key)].load();
+    if (exclusive) {
+      bucket->GetLatch().lock();
+    } else {
+      bucket->GetLatch().lock_shared();
+    }
+    // A concurrent split may have moved the key's slot to the new sibling while we waited for the latch.
+    if (dir_[IndexOf(key)].load() == bucket) {
+      return bucket;
+    }
+    if (exclusive) {
+      bucket->GetLatch().unlock();
+    } else {
+      bucket->GetLatch().unlock_shared();
+    }
+  }
+}
+
   /**
    *
    * TODO(P1): Add implementation
@@ -77,15 +105,10 @@ auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
    */
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
-    std::scoped_lock<std::mutex> lock(latch_);
-    auto index = IndexOf(key);
-    auto target_bucket = dir_[index];
-    if (target_bucket->Find(key, value)) {
-      return true;
-    } else {
-      return false;
-    }
-//  UNREACHABLE("not implemented");
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  Bucket *bucket = LatchBucket(key, false);
+  std::shared_lock<std::shared_mutex> bucket_lock(bucket->GetLatch(), std::adopt_lock);
+  return bucket->Find(key, value);
 }
  /**
      *
@@ -97,16 +120,10 @@ auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
      */
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
-    std::scoped_lock<std::mutex> lock(latch_);
-    
-    auto index = IndexOf(key);
-    auto target_bucket = dir_[index];
-    if (target_bucket->Remove(key)) {
-      return true;
-    } else {
-      return false;
-    }
-//  UNREACHABLE("not implemented");
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  Bucket *bucket = LatchBucket(key, true);
+  std::unique_lock<std::shared_mutex> bucket_lock(bucket->GetLatch(), std::adopt_lock);
+  return bucket->Remove(key);
 }
   /**
    *
@@ -125,64 +142,63 @@ auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
    */
 template <typename K, typename V>
 void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
-    std::scoped_lock<std::mutex> lock(latch_);
-    
-    while (dir_[IndexOf(key)]->IsFull()) {
-      auto index = IndexOf(key);
-      auto target_bucket = dir_[index];
-      if (target_bucket->GetDepth() == GetGlobalDepthInternal()) {
-        global_depth_++;
-        int length = dir_.size();
-        dir_.resize(length << 1);
-        for (int i = 0; i < length; ++i) {
-          dir_[i + length] = dir_[i];
-        }
-// why can not I commit?       
+  while (true) {
+    {
+      std::shared_lock<std::shared_mutex> lock(latch_);
+      Bucket *bucket = LatchBucket(key, true);
+      std::unique_lock<std::shared_mutex> bucket_lock(bucket->GetLatch(), std::adopt_lock);
+      if (bucket->Insert(key, value)) {
+        return;
       }
-      auto mask = 1 << target_bucket->GetDepth();
-      auto bucket_0 = std::make_shared<Bucket>(bucket_size_, target_bucket->GetDepth() + 1);
-      auto bucket_1 = std::make_shared<Bucket>(bucket_size_, target_bucket->GetDepth() + 1);
-      num_buckets_++;
-      for (const auto &item : target_bucket->GetItems()) {
-        auto hash_key = std::hash<K>()(item.first);
-        if ((hash_key & mask) == 0) {
-          bucket_0->Insert(item.first, item.second);
-
-        } else {
-          bucket_1->Insert(item.first, item.second);
-        }
-      }
-
-      for (size_t i = 0; i < dir_.size(); ++i) {
-        if (dir_[i] == target_bucket) {
-          if ((i & mask) == 0) {
-            dir_[i] = bucket_0;
-          } else {
-            dir_[i] = bucket_1;
-          }
-        }
+      if (bucket->GetDepth() < GetGlobalDepthInternal()) {
+        RedistributeBucket(bucket);
+        continue;
       }
     }
-    auto index = IndexOf(key);
-    auto target_bucket = dir_[index];
-    
-    target_bucket->Insert(key, value);
-/*  if (key is existed) {
-    old_value = value;
-  } else {
-    while (bucket_size_ == ) {
-      if (GetLocalDepth() == ) {
 
+    // The bucket is full and already as deep as the directory, so the directory has to double first.
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    Bucket *bucket = dir_[IndexOf(key)].load();
+    if (bucket->IsFull() && bucket->GetDepth() == GetGlobalDepthInternal()) {
+      size_t length = dir_.size();
+      std::vector<std::atomic<Bucket *>> dir(length << 1);
+      for (size_t i = 0; i < length; ++i) {
+        dir[i] = dir_[i].load();
+        dir[i + length] = dir_[i].load();
       }
-      Incre the local depth;
+      dir_ = std::move(dir);
+      global_depth_++;
+    }
+  }
+}
 
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::RedistributeBucket(Bucket *bucket) -> void {
+  // The bucket keeps the keys whose new depth bit is 0, the sibling takes the ones where it is 1.
+  auto mask = static_cast<size_t>(1) << bucket->GetDepth();
+  auto sibling = std::make_unique<Bucket>(bucket_size_, bucket->GetDepth() + 1);
+  bucket->IncrementDepth();
+  auto &items = bucket->GetItems();
+  for (auto it = items.begin(); it != items.end();) {
+    auto next = std::next(it);
+    if ((std::hash<K>()(it->first) & mask) != 0) {
+      sibling->GetItems().splice(sibling->GetItems().end(), items, it);
+    }
+    it = next;
+  }
 
-  //3.
-      split the bucket;
-      redistribute;
-   }
-  }*/
-//  UNREACHABLE("not implemented");
+  // The sibling is fully populated before any directory slot points at it.
+  Bucket *new_bucket = sibling.get();
+  {
+    std::scoped_lock<std::mutex> buckets_lock(buckets_latch_);
+    buckets_.push_back(std::move(sibling));
+  }
+  num_buckets_++;
+  for (size_t i = 0; i < dir_.size(); ++i) {
+    if ((i & mask) != 0 && dir_[i].load() == bucket) {
+      dir_[i] = new_bucket;
+    }
+  }
 }
 
 //===--------------------------------------------------------------------===//
@@ -249,19 +265,17 @@ auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
      */
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
-  //auto new_value = value;
-//  if (Find(key, value)) {
-    //Remove(key);
-//    list_.emplace_back(key, value);
-    //value = new_value;
-//  }
+  for (auto &item : list_) {
+    if (item.first == key) {
+      item.second = value;
+      return true;
+    }
+  }
   if (IsFull()) {
     return false;
   }
   list_.emplace_back(key, value);
   return true;
-
-  //UNREACHABLE("not implemented");
 }
 
 template class ExtendibleHashTable<page_id_t, Page *>;
@@ -1,29 +1,432 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * SIMPLE AGGREGATION HASH TABLE
+ *****************************************************************************/
+void SimpleAggregationHashTable::CombineAggregateValue(Value *result, uint32_t idx, const Value &input) {
+  switch (agg_types_[idx]) {
+    case AggregationType::CountStarAggregate:
+      *result = result->Add(ValueFactory::GetIntegerValue(1));
+      break;
+    case AggregationType::CountAggregate:
+      if (!input.IsNull()) {
+        *result = result->IsNull() ? ValueFactory::GetIntegerValue(1) : result->Add(ValueFactory::GetIntegerValue(1));
+      }
+      break;
+    case AggregationType::SumAggregate:
+      if (!input.IsNull()) {
+        *result = result->IsNull() ? input : result->Add(input);
+      }
+      break;
+    case AggregationType::MinAggregate:
+      if (!input.IsNull()) {
+        *result = result->IsNull() ? input : result->Min(input);
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (!input.IsNull()) {
+        *result = result->IsNull() ? input : result->Max(input);
+      }
+      break;
+  }
+}
+
+void SimpleAggregationHashTable::MergeAggregateValue(Value *result, uint32_t idx, const Value &partial) {
+  switch (agg_types_[idx]) {
+    case AggregationType::CountStarAggregate:
+      *result = result->Add(partial);
+      break;
+    case AggregationType::CountAggregate:
+    case AggregationType::SumAggregate:
+      if (!partial.IsNull()) {
+        *result = result->IsNull() ? partial : result->Add(partial);
+      }
+      break;
+    case AggregationType::MinAggregate:
+    case AggregationType::MaxAggregate:
+      CombineAggregateValue(result, idx, partial);
+      break;
+  }
+}
+
+void SimpleAggregationHashTable::SerializeKeyValue(const Value &value, std::vector<char> *buffer) {
+  // Layout: type id (1) | null flag (1) | value as serialized into a tuple, if not null
+  auto offset = buffer->size();
+  if (value.IsNull()) {
+    buffer->resize(offset + 2);
+    (*buffer)[offset] = static_cast<char>(value.GetTypeId());
+    (*buffer)[offset + 1] = 1;
+    return;
+  }
+  auto size = value.GetTypeId() == TypeId::VARCHAR ? sizeof(uint32_t) + value.GetLength()
+                                                    : Type::GetTypeSize(value.GetTypeId());
+  buffer->resize(offset + 2 + size);
+  (*buffer)[offset] = static_cast<char>(value.GetTypeId());
+  (*buffer)[offset + 1] = 0;
+  value.SerializeTo(buffer->data() + offset + 2);
+}
+
+auto SimpleAggregationHashTable::HashKey(const char *key, uint32_t key_size) -> hash_t {
+  // HashBytes barely mixes short keys, so mix it before splitting it into the control tag (low 7 bits) and the probe
+  // position (the rest).
+  return HashUtil::MixHash(HashUtil::HashBytes(key, key_size));
+}
+
+auto SimpleAggregationHashTable::FindOrInsertGroup(const char *key, uint32_t key_size, hash_t hash, bool create)
+    -> size_t {
+  // Keep at most 7/8 of the slots full so that every probe sequence reaches an empty slot.
+  if (create && (Size() + 1) * 8 > ctrl_.size() * 7) {
+    Grow();
+  }
+
+  if (ctrl_.empty()) {
+    return NO_GROUP;
+  }
+
+  const auto tag = static_cast<uint8_t>(hash & 0x7F);
+  const uint64_t tag_pattern = 0x0101010101010101ULL * tag;
+  const size_t group_mask = ctrl_.size() / GROUP_WIDTH - 1;
+  size_t probe_group = (hash >> 7) & group_mask;
+  for (size_t stride = 1;; stride++) {
+    uint64_t ctrl_word;
+    memcpy(&ctrl_word, ctrl_.data() + probe_group * GROUP_WIDTH, sizeof(ctrl_word));
+
+    // Bytes equal to the tag become zero; the classic zero-byte test flags them (rarely also a false positive,
+    // which the key comparison below rejects).
+    uint64_t diff = ctrl_word ^ tag_pattern;
+    uint64_t matches = (diff - 0x0101010101010101ULL) & ~diff & 0x8080808080808080ULL;
+    while (matches != 0) {
+      size_t slot = probe_group * GROUP_WIDTH + __builtin_ctzll(matches) / 8;
+      uint32_t group = slots_[slot];
+      if (hashes_[group] == hash && key_offsets_[group + 1] - key_offsets_[group] == key_size &&
+          memcmp(key_arena_.data() + key_offsets_[group], key, key_size) == 0) {
+        return group;
+      }
+      matches &= matches - 1;
+    }
+
+    uint64_t empties = ctrl_word & 0x8080808080808080ULL;
+    if (empties != 0) {
+      if (!create) {
+        return NO_GROUP;
+      }
+      size_t slot = probe_group * GROUP_WIDTH + __builtin_ctzll(empties) / 8;
+      auto group = static_cast<uint32_t>(Size());
+      ctrl_[slot] = tag;
+      slots_[slot] = group;
+      hashes_.push_back(hash);
+      key_arena_.insert(key_arena_.end(), key, key + key_size);
+      key_offsets_.push_back(key_arena_.size());
+      auto initial = GenerateInitialAggregateValue();
+      aggregates_.insert(aggregates_.end(), initial.aggregates_.begin(), initial.aggregates_.end());
+      return group;
+    }
+
+    // Triangular probing over groups visits every group when the group count is a power of two.
+    probe_group = (probe_group + stride) & group_mask;
+  }
+}
+
+void SimpleAggregationHashTable::Grow() {
+  size_t capacity = ctrl_.empty() ? GROUP_WIDTH * 2 : ctrl_.size() * 2;
+  ctrl_.assign(capacity, CTRL_EMPTY);
+  slots_.assign(capacity, 0);
+  const size_t group_mask = capacity / GROUP_WIDTH - 1;
+  for (uint32_t group = 0; group < Size(); group++) {
+    hash_t hash = hashes_[group];
+    size_t probe_group = (hash >> 7) & group_mask;
+    for (size_t stride = 1;; stride++) {
+      uint64_t ctrl_word;
+      memcpy(&ctrl_word, ctrl_.data() + probe_group * GROUP_WIDTH, sizeof(ctrl_word));
+      uint64_t empties = ctrl_word & 0x8080808080808080ULL;
+      if (empties != 0) {
+        size_t slot = probe_group * GROUP_WIDTH + __builtin_ctzll(empties) / 8;
+        ctrl_[slot] = static_cast<uint8_t>(hash & 0x7F);
+        slots_[slot] = group;
+        break;
+      }
+      probe_group = (probe_group + stride) & group_mask;
+    }
+  }
+}
+
+void SimpleAggregationHashTable::InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+  key_buffer_.clear();
+  for (const auto &value : agg_key.group_bys_) {
+    SerializeKeyValue(value, &key_buffer_);
+  }
+  auto key_size = static_cast<uint32_t>(key_buffer_.size());
+  auto group = FindOrInsertGroup(key_buffer_.data(), key_size, HashKey(key_buffer_.data(), key_size));
+  Value *result = aggregates_.data() + group * agg_types_.size();
+  for (uint32_t i = 0; i < agg_types_.size(); i++) {
+    CombineAggregateValue(&result[i], i, agg_val.aggregates_[i]);
+  }
+}
+
+void SimpleAggregationHashTable::InsertCombine(const TupleBatch &batch,
+                                               const std::vector<AbstractExpressionRef> &group_bys, bool create_group,
+                                               std::vector<std::pair<size_t, hash_t>> *rejected) {
+  group_by_columns_.resize(group_bys.size());
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    group_bys[i]->EvaluateBatch(batch, &group_by_columns_[i]);
+  }
+  aggregate_columns_.resize(agg_types_.size());
+  for (size_t i = 0; i < agg_types_.size(); i++) {
+    if (agg_types_[i] != AggregationType::CountStarAggregate) {
+      agg_exprs_[i]->EvaluateBatch(batch, &aggregate_columns_[i]);
+    }
+  }
+
+  size_t group = NO_GROUP;
+  hash_t hash = 0;
+  for (size_t row = 0; row < batch.Size(); row++) {
+    // Without GROUP BY every row goes to the same group, which only has to be looked up once.
+    if (row == 0 || !group_bys.empty()) {
+      key_buffer_.clear();
+      for (const auto &column : group_by_columns_) {
+        SerializeKeyValue(column[row], &key_buffer_);
+      }
+      auto key_size = static_cast<uint32_t>(key_buffer_.size());
+      hash = HashKey(key_buffer_.data(), key_size);
+      group = FindOrInsertGroup(key_buffer_.data(), key_size, hash, create_group);
+    }
+    if (group == NO_GROUP) {
+      if (rejected != nullptr) {
+        rejected->emplace_back(row, hash);
+      }
+      continue;
+    }
+    Value *result = aggregates_.data() + group * agg_types_.size();
+    for (uint32_t i = 0; i < agg_types_.size(); i++) {
+      if (agg_types_[i] == AggregationType::CountStarAggregate) {
+        CombineAggregateValue(&result[i], i, result[i]);
+      } else {
+        CombineAggregateValue(&result[i], i, aggregate_columns_[i][row]);
+      }
+    }
+  }
+}
+
+void SimpleAggregationHashTable::Merge(const SimpleAggregationHashTable &other) {
+  for (size_t other_group = 0; other_group < other.Size(); other_group++) {
+    const char *key = other.key_arena_.data() + other.key_offsets_[other_group];
+    auto key_size = other.key_offsets_[other_group + 1] - other.key_offsets_[other_group];
+    auto group = FindOrInsertGroup(key, key_size, other.hashes_[other_group]);
+    Value *result = aggregates_.data() + group * agg_types_.size();
+    const Value *partial = other.aggregates_.data() + other_group * agg_types_.size();
+    for (uint32_t i = 0; i < agg_types_.size(); i++) {
+      MergeAggregateValue(&result[i], i, partial[i]);
+    }
+  }
+}
+
+void SimpleAggregationHashTable::Clear() {
+  // Release the memory as well, the budget of a spilling aggregation is checked against the capacity.
+  ctrl_ = {};
+  slots_ = {};
+  hashes_ = {};
+  key_arena_ = {};
+  key_offsets_ = {0};
+  aggregates_ = {};
+}
+
+auto SimpleAggregationHashTable::GetKey(size_t group) const -> AggregateKey {
+  std::vector<Value> keys;
+  const char *key = key_arena_.data() + key_offsets_[group];
+  const char *end = key_arena_.data() + key_offsets_[group + 1];
+  while (key < end) {
+    auto type_id = static_cast<TypeId>(key[0]);
+    if (key[1] != 0) {
+      keys.emplace_back(ValueFactory::GetNullValueByType(type_id));
+      key += 2;
+      continue;
+    }
+    keys.emplace_back(Value::DeserializeFrom(key + 2, type_id));
+    key += 2 + (type_id == TypeId::VARCHAR ? sizeof(uint32_t) + keys.back().GetLength() : Type::GetTypeSize(type_id));
+  }
+  return {keys};
+}
+
+auto SimpleAggregationHashTable::GetAggregates(size_t group) const -> AggregateValue {
+  auto begin = aggregates_.begin() + group * agg_types_.size();
+  return {std::vector<Value>(begin, begin + agg_types_.size())};
+}
+
+/*****************************************************************************
+ * AGGREGATION EXECUTOR
+ *****************************************************************************/
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      child_{std::move(child)},
+      gather_{dynamic_cast<GatherExecutor *>(child_.get())},
+      aht_{plan->GetAggregates(), plan->GetAggregateTypes()},
+      aht_iterator_{aht_.Begin()} {}
+
+void AggregationExecutor::Init() {
+  child_->Init();
+  partitions_.clear();
+  aht_.Clear();
+
+  if (gather_ != nullptr) {
+    AggregateParallel();
+  } else {
+    Aggregate([this](TupleBatch *batch) { return child_->NextBatch(batch); }, 0);
+  }
+  aht_iterator_ = aht_.Begin();
+  empty_result_emitted_ = false;
+}
+
+void AggregationExecutor::Aggregate(const std::function<bool(TupleBatch *)> &next, uint32_t depth) {
+  // Every level partitions on the next bits of the group key hash, starting from the top ones. The hash table itself
+  // only probes on the low bits, so the groups of a partition still spread over the whole table.
+  constexpr uint32_t partition_bits = __builtin_ctzll(AGGREGATION_SPILL_PARTITIONS);
+  static_assert((AGGREGATION_SPILL_PARTITIONS & (AGGREGATION_SPILL_PARTITIONS - 1)) == 0);
+  const uint32_t shift = 64 - (depth + 1) * partition_bits;
+  // Past this depth the low hash bits would be reused, so a partition that is still too big is kept in memory.
+  const bool can_spill = (depth + 1) * partition_bits <= 32;
+
+  std::vector<std::unique_ptr<TmpTuplePartition>> spilled{};
+  std::vector<std::pair<size_t, hash_t>> rejected{};
+  TupleBatch batch{};
+  while (next(&batch)) {
+    // The budget is checked once per batch, so the table may go over it by at most one batch of groups.
+    bool in_memory = !can_spill || aht_.MemoryUsage() < AGGREGATION_MEMORY_BUDGET;
+    rejected.clear();
+    aht_.InsertCombine(batch, plan_->GetGroupBys(), in_memory, &rejected);
+    if (rejected.empty()) {
+      continue;
+    }
+    if (spilled.empty()) {
+      for (size_t i = 0; i < AGGREGATION_SPILL_PARTITIONS; i++) {
+        spilled.emplace_back(std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager()));
+      }
+    }
+    for (const auto &[row, hash] : rejected) {
+      spilled[(hash >> shift) & (AGGREGATION_SPILL_PARTITIONS - 1)]->Append(batch.GetTuple(row));
+    }
+  }
+
+  for (auto &partition : spilled) {
+    if (partition->Size() != 0) {
+      partition->FinishAppend();
+      partitions_.push_back({std::move(partition), depth + 1});
+    }
+  }
+}
+
+void AggregationExecutor::AggregateParallel() {
+  const size_t num_workers = gather_->GetWorkerCount();
+  std::vector<std::unique_ptr<SimpleAggregationHashTable>> tables{};
+  std::vector<std::unique_ptr<TmpTuplePartition>> spilled{};
+  std::vector<std::vector<std::pair<size_t, hash_t>>> rejected(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    tables.push_back(std::make_unique<SimpleAggregationHashTable>(plan_->GetAggregates(), plan_->GetAggregateTypes()));
+    spilled.push_back(std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager()));
+  }
+
+  gather_->RunOnWorkers([&](size_t worker, TupleBatch *batch) {
+    bool in_memory = tables[worker]->MemoryUsage() < AGGREGATION_MEMORY_BUDGET / num_workers;
+    rejected[worker].clear();
+    tables[worker]->InsertCombine(*batch, plan_->GetGroupBys(), in_memory, &rejected[worker]);
+    for (const auto &[row, hash] : rejected[worker]) {
+      spilled[worker]->Append(batch->GetTuple(row));
+    }
+  });
+
+  for (auto &table : tables) {
+    aht_.Merge(*table);
+    table.reset();
+  }
+
+  // A row a worker could not fit may still belong to a group another worker had, so the rows are combined with the
+  // merged table first. Only the rows of groups that are not in the merged table are partitioned and spilled.
+  for (auto &partition : spilled) {
+    partition->FinishAppend();
+  }
+  size_t next_partition = 0;
+  Aggregate(
+      [&](TupleBatch *batch) {
+        for (; next_partition < spilled.size(); spilled[next_partition++].reset()) {
+          if (spilled[next_partition]->NextBatch(&child_->GetOutputSchema(), batch)) {
+            return true;
+          }
+        }
+        return false;
+      },
+      0);
+}
+
+auto AggregationExecutor::AggregateNextPartition() -> bool {
+  if (partitions_.empty()) {
+    return false;
+  }
+  SpillPartition partition = std::move(partitions_.back());
+  partitions_.pop_back();
+  aht_.Clear();
+  Aggregate([&](TupleBatch *batch) { return partition.tuples_->NextBatch(&child_->GetOutputSchema(), batch); },
+            partition.depth_);
+  return true;
+}
+
+auto AggregationExecutor::NextRow(std::vector<Value> *values) -> bool {
+  values->clear();
+  while (aht_iterator_ == aht_.End() && AggregateNextPartition()) {
+    aht_iterator_ = aht_.Begin();
+  }
+  if (aht_iterator_ == aht_.End()) {
+    // An aggregation without GROUP BY still produces one row over empty input.
+    if (aht_.Size() != 0 || !plan_->GetGroupBys().empty() || empty_result_emitted_) {
+      return false;
+    }
+    empty_result_emitted_ = true;
+    *values = aht_.GenerateInitialAggregateValue().aggregates_;
+    return true;
+  }
+  auto key = aht_iterator_.Key();
+  auto val = aht_iterator_.Val();
+  values->insert(values->end(), key.group_bys_.begin(), key.group_bys_.end());
+  values->insert(values->end(), val.aggregates_.begin(), val.aggregates_.end());
+  ++aht_iterator_;
+  return true;
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  std::vector<Value> values{};
+  if (!NextRow(&values)) {
+    return false;
+  }
+  *tuple = Tuple{values, &GetOutputSchema()};
+  return true;
+}
+
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  std::vector<Value> values{};
+  while (!batch->IsFull() && NextRow(&values)) {
+    batch->AppendRow(values);
+  }
+  return batch->Size() != 0;
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
+
+}  // namespace bustub
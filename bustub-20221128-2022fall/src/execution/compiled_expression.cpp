@@ -0,0 +1,340 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.cpp
+//
+// Identification: src/execution/compiled_expression.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_expression.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+template <typename T, typename Op>
+void CompareLanes(const T *lhs, const T *rhs, int64_t *dst, size_t rows) {
+  Op op;
+  for (size_t i = 0; i < rows; i++) {
+    dst[i] = op(lhs[i], rhs[i]) ? 1 : 0;
+  }
+}
+
+template <typename T>
+void CompareLanes(ComparisonType type, const T *lhs, const T *rhs, int64_t *dst, size_t rows) {
+  switch (type) {
+    case ComparisonType::Equal:
+      return CompareLanes<T, std::equal_to<T>>(lhs, rhs, dst, rows);
+    case ComparisonType::NotEqual:
+      return CompareLanes<T, std::not_equal_to<T>>(lhs, rhs, dst, rows);
+    case ComparisonType::LessThan:
+      return CompareLanes<T, std::less<T>>(lhs, rhs, dst, rows);
+    case ComparisonType::LessThanOrEqual:
+      return CompareLanes<T, std::less_equal<T>>(lhs, rhs, dst, rows);
+    case ComparisonType::GreaterThan:
+      return CompareLanes<T, std::greater<T>>(lhs, rhs, dst, rows);
+    case ComparisonType::GreaterThanOrEqual:
+      return CompareLanes<T, std::greater_equal<T>>(lhs, rhs, dst, rows);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+/** Reads the lanes of a column of an integer type */
+template <typename T>
+void LoadIntegers(const TupleBatch &batch, uint32_t column, int64_t *ints, uint8_t *nulls) {
+  for (size_t i = 0; i < batch.Size(); i++) {
+    const Value &value = batch.GetValue(i, column);
+    nulls[i] = value.IsNull() ? 1 : 0;
+    ints[i] = value.GetAs<T>();
+  }
+}
+
+}  // namespace
+
+auto CompiledExpression::Compile(const AbstractExpression &expr) -> std::unique_ptr<CompiledExpression> {
+  // Columns and constants are copied as they are, translating them to lanes and back would only cost time.
+  if (dynamic_cast<const ComparisonExpression *>(&expr) == nullptr &&
+      dynamic_cast<const ArithmeticExpression *>(&expr) == nullptr &&
+      dynamic_cast<const LogicExpression *>(&expr) == nullptr) {
+    return nullptr;
+  }
+  std::unique_ptr<CompiledExpression> compiled{new CompiledExpression()};
+  if (!compiled->Emit(expr).has_value()) {
+    return nullptr;
+  }
+  compiled->result_type_ = expr.GetReturnType();
+  return compiled;
+}
+
+auto CompiledExpression::NewRegister(RegisterType type) -> uint32_t {
+  registers_.push_back(Register{type});
+  return registers_.size() - 1;
+}
+
+auto CompiledExpression::Emit(const AbstractExpression &expr) -> std::optional<uint32_t> {
+  auto register_type = [](TypeId type) -> std::optional<RegisterType> {
+    switch (type) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+        return RegisterType::Integer;
+      case TypeId::BOOLEAN:
+        return RegisterType::Boolean;
+      case TypeId::DECIMAL:
+        return RegisterType::Decimal;
+      default:
+        return std::nullopt;
+    }
+  };
+
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(&expr); column != nullptr) {
+    auto type = register_type(column->GetReturnType());
+    if (column->GetTupleIdx() != 0 || !type.has_value()) {
+      return std::nullopt;
+    }
+    Instruction instr{OpCode::LoadColumn, NewRegister(*type)};
+    instr.column_ = column->GetColIdx();
+    instr.type_ = column->GetReturnType();
+    program_.push_back(instr);
+    return instr.dst_;
+  }
+
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(&expr); constant != nullptr) {
+    auto type = register_type(constant->val_.GetTypeId());
+    if (!type.has_value()) {
+      return std::nullopt;
+    }
+    Instruction instr{OpCode::LoadConstant, NewRegister(*type)};
+    instr.type_ = constant->val_.GetTypeId();
+    instr.constant_ = constant->val_;
+    program_.push_back(instr);
+    return instr.dst_;
+  }
+
+  if (expr.GetChildren().size() != 2) {
+    return std::nullopt;
+  }
+  auto lhs = Emit(*expr.GetChildAt(0));
+  auto rhs = lhs.has_value() ? Emit(*expr.GetChildAt(1)) : std::nullopt;
+  if (!rhs.has_value()) {
+    return std::nullopt;
+  }
+  RegisterType lhs_type = registers_[*lhs].type_;
+  RegisterType rhs_type = registers_[*rhs].type_;
+
+  if (const auto *comparison = dynamic_cast<const ComparisonExpression *>(&expr); comparison != nullptr) {
+    if ((lhs_type == RegisterType::Boolean) != (rhs_type == RegisterType::Boolean)) {
+      return std::nullopt;
+    }
+    // Like Value, compare an integer with a decimal as two decimals.
+    if (lhs_type != rhs_type) {
+      uint32_t *integer = lhs_type == RegisterType::Integer ? &*lhs : &*rhs;
+      Instruction cast{OpCode::IntegerToDecimal, NewRegister(RegisterType::Decimal), *integer};
+      program_.push_back(cast);
+      *integer = cast.dst_;
+    }
+    Instruction instr{OpCode::Compare, NewRegister(RegisterType::Boolean), *lhs, *rhs};
+    instr.comparison_ = comparison->comp_type_;
+    program_.push_back(instr);
+    return instr.dst_;
+  }
+
+  if (const auto *arithmetic = dynamic_cast<const ArithmeticExpression *>(&expr); arithmetic != nullptr) {
+    if (lhs_type != RegisterType::Integer || rhs_type != RegisterType::Integer) {
+      return std::nullopt;
+    }
+    Instruction instr{OpCode::Arithmetic, NewRegister(RegisterType::Integer), *lhs, *rhs};
+    instr.arithmetic_ = arithmetic->compute_type_;
+    program_.push_back(instr);
+    return instr.dst_;
+  }
+
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(&expr); logic != nullptr) {
+    if (lhs_type != RegisterType::Boolean || rhs_type != RegisterType::Boolean) {
+      return std::nullopt;
+    }
+    OpCode op = logic->logic_type_ == LogicType::And ? OpCode::And : OpCode::Or;
+    program_.push_back(Instruction{op, NewRegister(RegisterType::Boolean), *lhs, *rhs});
+    return program_.back().dst_;
+  }
+
+  return std::nullopt;
+}
+
+void CompiledExpression::LoadColumn(const Instruction &instr, const TupleBatch &batch, Register *dst) {
+  int64_t *ints = dst->ints_.data();
+  uint8_t *nulls = dst->nulls_.data();
+  switch (instr.type_) {
+    case TypeId::TINYINT:
+      return LoadIntegers<int8_t>(batch, instr.column_, ints, nulls);
+    case TypeId::SMALLINT:
+      return LoadIntegers<int16_t>(batch, instr.column_, ints, nulls);
+    case TypeId::INTEGER:
+      return LoadIntegers<int32_t>(batch, instr.column_, ints, nulls);
+    case TypeId::BIGINT:
+      return LoadIntegers<int64_t>(batch, instr.column_, ints, nulls);
+    case TypeId::BOOLEAN:
+      // Boolean lanes are always 0 or 1, also for nulls, which the logic instructions rely on.
+      for (size_t i = 0; i < batch.Size(); i++) {
+        const Value &value = batch.GetValue(i, instr.column_);
+        nulls[i] = value.IsNull() ? 1 : 0;
+        ints[i] = !value.IsNull() && value.GetAs<bool>() ? 1 : 0;
+      }
+      return;
+    case TypeId::DECIMAL:
+      for (size_t i = 0; i < batch.Size(); i++) {
+        const Value &value = batch.GetValue(i, instr.column_);
+        nulls[i] = value.IsNull() ? 1 : 0;
+        dst->decimals_[i] = value.GetAs<double>();
+      }
+      return;
+    default:
+      UNREACHABLE("Unsupported column type.");
+  }
+}
+
+void CompiledExpression::LoadConstant(const Instruction &instr, size_t rows, Register *dst) {
+  const Value &value = *instr.constant_;
+  std::fill_n(dst->nulls_.begin(), rows, value.IsNull() ? 1 : 0);
+  switch (instr.type_) {
+    case TypeId::TINYINT:
+      std::fill_n(dst->ints_.begin(), rows, value.GetAs<int8_t>());
+      return;
+    case TypeId::SMALLINT:
+      std::fill_n(dst->ints_.begin(), rows, value.GetAs<int16_t>());
+      return;
+    case TypeId::INTEGER:
+      std::fill_n(dst->ints_.begin(), rows, value.GetAs<int32_t>());
+      return;
+    case TypeId::BIGINT:
+      std::fill_n(dst->ints_.begin(), rows, value.GetAs<int64_t>());
+      return;
+    case TypeId::BOOLEAN:
+      std::fill_n(dst->ints_.begin(), rows, !value.IsNull() && value.GetAs<bool>() ? 1 : 0);
+      return;
+    case TypeId::DECIMAL:
+      std::fill_n(dst->decimals_.begin(), rows, value.GetAs<double>());
+      return;
+    default:
+      UNREACHABLE("Unsupported constant type.");
+  }
+}
+
+void CompiledExpression::Compare(const Instruction &instr, size_t rows) {
+  const Register &lhs = registers_[instr.lhs_];
+  const Register &rhs = registers_[instr.rhs_];
+  Register &dst = registers_[instr.dst_];
+  for (size_t i = 0; i < rows; i++) {
+    dst.nulls_[i] = lhs.nulls_[i] | rhs.nulls_[i];
+  }
+  if (lhs.type_ == RegisterType::Decimal) {
+    CompareLanes(instr.comparison_, lhs.decimals_.data(), rhs.decimals_.data(), dst.ints_.data(), rows);
+  } else {
+    CompareLanes(instr.comparison_, lhs.ints_.data(), rhs.ints_.data(), dst.ints_.data(), rows);
+  }
+}
+
+void CompiledExpression::Run(const TupleBatch &batch) {
+  const size_t rows = batch.Size();
+  for (auto &reg : registers_) {
+    reg.nulls_.resize(rows);
+    if (reg.type_ == RegisterType::Decimal) {
+      reg.decimals_.resize(rows);
+    } else {
+      reg.ints_.resize(rows);
+    }
+  }
+
+  for (const auto &instr : program_) {
+    Register &dst = registers_[instr.dst_];
+    const Register &lhs = registers_[instr.lhs_];
+    const Register &rhs = registers_[instr.rhs_];
+    switch (instr.op_) {
+      case OpCode::LoadColumn:
+        LoadColumn(instr, batch, &dst);
+        break;
+      case OpCode::LoadConstant:
+        LoadConstant(instr, rows, &dst);
+        break;
+      case OpCode::IntegerToDecimal:
+        for (size_t i = 0; i < rows; i++) {
+          dst.nulls_[i] = lhs.nulls_[i];
+          dst.decimals_[i] = static_cast<double>(lhs.ints_[i]);
+        }
+        break;
+      case OpCode::Compare:
+        Compare(instr, rows);
+        break;
+      case OpCode::Arithmetic:
+        // INTEGER arithmetic wraps around at 32 bits, and a result that hits the null marker is null, as with Value.
+        for (size_t i = 0; i < rows; i++) {
+          auto l = static_cast<uint32_t>(lhs.ints_[i]);
+          auto r = static_cast<uint32_t>(rhs.ints_[i]);
+          auto res = static_cast<int32_t>(instr.arithmetic_ == ArithmeticType::Plus ? l + r : l - r);
+          dst.ints_[i] = res;
+          dst.nulls_[i] = lhs.nulls_[i] | rhs.nulls_[i] | static_cast<uint8_t>(res == BUSTUB_INT32_NULL);
+        }
+        break;
+      case OpCode::And:
+        // The result is known to be false if either side is false, even if the other one is null.
+        for (size_t i = 0; i < rows; i++) {
+          uint8_t has_false = ((lhs.nulls_[i] | lhs.ints_[i]) ^ 1) | ((rhs.nulls_[i] | rhs.ints_[i]) ^ 1);
+          dst.ints_[i] = lhs.ints_[i] & rhs.ints_[i];
+          dst.nulls_[i] = (lhs.nulls_[i] | rhs.nulls_[i]) & (has_false ^ 1);
+        }
+        break;
+      case OpCode::Or:
+        // The result is known to be true if either side is true, even if the other one is null.
+        for (size_t i = 0; i < rows; i++) {
+          uint8_t has_true = ((lhs.nulls_[i] ^ 1) & lhs.ints_[i]) | ((rhs.nulls_[i] ^ 1) & rhs.ints_[i]);
+          dst.ints_[i] = has_true;
+          dst.nulls_[i] = (lhs.nulls_[i] | rhs.nulls_[i]) & (has_true ^ 1);
+        }
+        break;
+    }
+  }
+}
+
+void CompiledExpression::EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) {
+  Run(batch);
+  const Register &out = registers_.back();
+  result->clear();
+  result->reserve(batch.Size());
+  for (size_t i = 0; i < batch.Size(); i++) {
+    if (result_type_ == TypeId::BOOLEAN) {
+      result->push_back(ValueFactory::GetBooleanValue(
+          out.nulls_[i] != 0 ? BUSTUB_BOOLEAN_NULL : static_cast<int8_t>(out.ints_[i])));
+    } else {
+      result->push_back(ValueFactory::GetIntegerValue(
+          out.nulls_[i] != 0 ? BUSTUB_INT32_NULL : static_cast<int32_t>(out.ints_[i])));
+    }
+  }
+}
+
+void CompiledExpression::Select(const TupleBatch &batch, std::vector<uint32_t> *selection) {
+  BUSTUB_ASSERT(result_type_ == TypeId::BOOLEAN, "only a boolean expression can select rows");
+  Run(batch);
+  const Register &out = registers_.back();
+  selection->clear();
+  for (size_t i = 0; i < batch.Size(); i++) {
+    if (out.nulls_[i] == 0 && out.ints_[i] != 0) {
+      selection->push_back(batch.RowAt(i));
+    }
+  }
+}
+
+}  // namespace bustub
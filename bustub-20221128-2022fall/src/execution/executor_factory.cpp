@@ -19,10 +19,12 @@
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/filter_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
+#include "execution/executors/merge_join_executor.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
@@ -42,6 +44,14 @@
 
 namespace bustub {
 
+auto ExecutorFactory::CreateBreakerInput(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+    -> std::unique_ptr<AbstractExecutor> {
+  if (exec_ctx->GetWorkerCount() > 1 && GatherExecutor::IsParallelPipeline(*plan)) {
+    return std::make_unique<GatherExecutor>(exec_ctx, plan);
+  }
+  return ExecutorFactory::CreateExecutor(exec_ctx, plan);
+}
+
 auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
     -> std::unique_ptr<AbstractExecutor> {
   switch (plan->GetType()) {
@@ -86,7 +96,7 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
     // Create a new aggregation executor
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan.get());
-      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, agg_plan->GetChildPlan());
+      auto child_executor = CreateBreakerInput(exec_ctx, agg_plan->GetChildPlan());
       return std::make_unique<AggregationExecutor>(exec_ctx, agg_plan, std::move(child_executor));
     }
 
@@ -109,11 +119,19 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
     // Create a new hash join executor
     case PlanType::HashJoin: {
       auto hash_join_plan = dynamic_cast<const HashJoinPlanNode *>(plan.get());
-      auto left = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetLeftPlan());
-      auto right = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetRightPlan());
+      auto left = CreateBreakerInput(exec_ctx, hash_join_plan->GetLeftPlan());
+      auto right = CreateBreakerInput(exec_ctx, hash_join_plan->GetRightPlan());
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new merge join executor
+    case PlanType::MergeJoin: {
+      auto merge_join_plan = dynamic_cast<const MergeJoinPlanNode *>(plan.get());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetRightPlan());
+      return std::make_unique<MergeJoinExecutor>(exec_ctx, merge_join_plan, std::move(left), std::move(right));
+    }
+
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
@@ -143,14 +161,14 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       // Create a new sort executor
     case PlanType::Sort: {
       const auto *sort_plan = dynamic_cast<const SortPlanNode *>(plan.get());
-      auto child = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      auto child = CreateBreakerInput(exec_ctx, sort_plan->GetChildPlan());
       return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child));
     }
 
       // Create a new topN executor
     case PlanType::TopN: {
       const auto *topn_plan = dynamic_cast<const TopNPlanNode *>(plan.get());
-      auto child = ExecutorFactory::CreateExecutor(exec_ctx, topn_plan->GetChildPlan());
+      auto child = CreateBreakerInput(exec_ctx, topn_plan->GetChildPlan());
       return std::make_unique<TopNExecutor>(exec_ctx, topn_plan, std::move(child));
     }
 
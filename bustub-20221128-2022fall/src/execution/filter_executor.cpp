@@ -11,6 +11,7 @@ FilterExecutor::FilterExecutor(ExecutorContext *exec_ctx, const FilterPlanNode *
 void FilterExecutor::Init() {
   // Initialize the child executor
   child_executor_->Init();
+  compiled_predicate_ = CompiledExpression::Compile(*plan_->GetPredicate());
 }
 
 auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -31,4 +32,35 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  while (child_executor_->NextBatch(batch)) {
+    if (FilterBatch(*plan_, compiled_predicate_.get(), batch)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto FilterExecutor::FilterBatch(const FilterPlanNode &plan, CompiledExpression *compiled_predicate, TupleBatch *batch)
+    -> bool {
+  std::vector<uint32_t> selection{};
+  if (compiled_predicate != nullptr) {
+    compiled_predicate->Select(*batch, &selection);
+  } else {
+    std::vector<Value> values{};
+    plan.GetPredicate()->EvaluateBatch(*batch, &values);
+    selection.reserve(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      if (!values[i].IsNull() && values[i].GetAs<bool>()) {
+        selection.push_back(batch->RowAt(i));
+      }
+    }
+  }
+  if (selection.empty()) {
+    return false;
+  }
+  batch->SetSelection(std::move(selection));
+  return true;
+}
+
 }  // namespace bustub
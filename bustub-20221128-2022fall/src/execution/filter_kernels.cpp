@@ -0,0 +1,338 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.cpp
+//
+// Identification: src/execution/filter_kernels.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/filter_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/limits.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace bustub {
+
+namespace {
+
+template <typename T>
+constexpr auto NullOf() -> T {
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return BUSTUB_INT32_NULL;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return BUSTUB_INT64_NULL;
+  } else {
+    return BUSTUB_DECIMAL_NULL;
+  }
+}
+
+/*
+ * The comparisons. Scalar compares two values; where SSE2 is available, Int32 and Double compare the lanes of two
+ * registers and return all ones in the lanes the comparison is true for.
+ */
+struct Equal {
+  template <typename T>
+  static auto Scalar(T a, T b) -> bool {
+    return a == b;
+  }
+#ifdef __SSE2__
+  static auto Int32(__m128i a, __m128i b) -> __m128i { return _mm_cmpeq_epi32(a, b); }
+  static auto Double(__m128d a, __m128d b) -> __m128d { return _mm_cmpeq_pd(a, b); }
+#endif
+};
+
+struct NotEqual {
+  template <typename T>
+  static auto Scalar(T a, T b) -> bool {
+    return a != b;
+  }
+#ifdef __SSE2__
+  static auto Int32(__m128i a, __m128i b) -> __m128i {
+    return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1));
+  }
+  static auto Double(__m128d a, __m128d b) -> __m128d { return _mm_cmpneq_pd(a, b); }
+#endif
+};
+
+struct LessThan {
+  template <typename T>
+  static auto Scalar(T a, T b) -> bool {
+    return a < b;
+  }
+#ifdef __SSE2__
+  static auto Int32(__m128i a, __m128i b) -> __m128i { return _mm_cmplt_epi32(a, b); }
+  static auto Double(__m128d a, __m128d b) -> __m128d { return _mm_cmplt_pd(a, b); }
+#endif
+};
+
+struct LessThanOrEqual {
+  template <typename T>
+  static auto Scalar(T a, T b) -> bool {
+    return a <= b;
+  }
+#ifdef __SSE2__
+  static auto Int32(__m128i a, __m128i b) -> __m128i {
+    return _mm_xor_si128(_mm_cmpgt_epi32(a, b), _mm_set1_epi32(-1));
+  }
+  static auto Double(__m128d a, __m128d b) -> __m128d { return _mm_cmple_pd(a, b); }
+#endif
+};
+
+struct GreaterThan {
+  template <typename T>
+  static auto Scalar(T a, T b) -> bool {
+    return a > b;
+  }
+#ifdef __SSE2__
+  static auto Int32(__m128i a, __m128i b) -> __m128i { return _mm_cmpgt_epi32(a, b); }
+  static auto Double(__m128d a, __m128d b) -> __m128d { return _mm_cmpgt_pd(a, b); }
+#endif
+};
+
+struct GreaterThanOrEqual {
+  template <typename T>
+  static auto Scalar(T a, T b) -> bool {
+    return a >= b;
+  }
+#ifdef __SSE2__
+  static auto Int32(__m128i a, __m128i b) -> __m128i {
+    return _mm_xor_si128(_mm_cmplt_epi32(a, b), _mm_set1_epi32(-1));
+  }
+  static auto Double(__m128d a, __m128d b) -> __m128d { return _mm_cmpge_pd(a, b); }
+#endif
+};
+
+/** Computes the bits of the values from `begin` on, one at a time, without branches */
+template <typename T, typename Op>
+void CompareScalar(const T *values, size_t begin, size_t rows, T constant, uint64_t *bitmap) {
+  const T null = NullOf<T>();
+  for (size_t i = begin; i < rows; i++) {
+    auto bit = static_cast<uint64_t>(values[i] != null && Op::Scalar(values[i], constant));
+    bitmap[i / 64] |= bit << (i % 64);
+  }
+}
+
+/** @return The number of values the SIMD loop handled, the rest is left to CompareScalar */
+template <typename T, typename Op>
+auto CompareVector(const T *values, size_t rows, T constant, uint64_t *bitmap) -> size_t {
+#ifdef __SSE2__
+  const size_t words = rows / 64;
+  if constexpr (std::is_same_v<T, int32_t>) {
+    const __m128i c = _mm_set1_epi32(constant);
+    const __m128i null = _mm_set1_epi32(NullOf<T>());
+    for (size_t w = 0; w < words; w++) {
+      uint64_t word = 0;
+      for (size_t j = 0; j < 64; j += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + w * 64 + j));
+        __m128i hit = _mm_andnot_si128(_mm_cmpeq_epi32(v, null), Op::Int32(v, c));
+        word |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hit))) << j;
+      }
+      bitmap[w] = word;
+    }
+    return words * 64;
+  } else if constexpr (std::is_same_v<T, double>) {
+    const __m128d c = _mm_set1_pd(constant);
+    const __m128d null = _mm_set1_pd(NullOf<T>());
+    for (size_t w = 0; w < words; w++) {
+      uint64_t word = 0;
+      for (size_t j = 0; j < 64; j += 2) {
+        __m128d v = _mm_loadu_pd(values + w * 64 + j);
+        __m128d hit = _mm_and_pd(_mm_cmpneq_pd(v, null), Op::Double(v, c));
+        word |= static_cast<uint64_t>(_mm_movemask_pd(hit)) << j;
+      }
+      bitmap[w] = word;
+    }
+    return words * 64;
+  }
+#endif
+  // SSE2 has no 64-bit integer comparisons, BIGINT is compared one value at a time.
+  return 0;
+}
+
+template <typename T, typename Op>
+void Compare(const T *values, size_t rows, T constant, uint64_t *bitmap) {
+  size_t done = CompareVector<T, Op>(values, rows, constant, bitmap);
+  std::fill(bitmap + done / 64, bitmap + BitmapWords(rows), 0);
+  CompareScalar<T, Op>(values, done, rows, constant, bitmap);
+}
+
+/** @return The comparison with its operands swapped, such that `a op b` is `b Flip(op) a` */
+auto Flip(ComparisonType comparison) -> ComparisonType {
+  switch (comparison) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comparison;
+  }
+}
+
+/** Appends the terms of a conjunction */
+void CollectConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *terms) {
+  const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+  if (logic != nullptr && logic->logic_type_ == LogicType::And) {
+    CollectConjuncts(logic->GetChildAt(0), terms);
+    CollectConjuncts(logic->GetChildAt(1), terms);
+    return;
+  }
+  terms->push_back(expr);
+}
+
+}  // namespace
+
+template <typename T>
+void CompareWithConstant(ComparisonType comparison, const T *values, size_t rows, T constant, uint64_t *bitmap) {
+  switch (comparison) {
+    case ComparisonType::Equal:
+      return Compare<T, Equal>(values, rows, constant, bitmap);
+    case ComparisonType::NotEqual:
+      return Compare<T, NotEqual>(values, rows, constant, bitmap);
+    case ComparisonType::LessThan:
+      return Compare<T, LessThan>(values, rows, constant, bitmap);
+    case ComparisonType::LessThanOrEqual:
+      return Compare<T, LessThanOrEqual>(values, rows, constant, bitmap);
+    case ComparisonType::GreaterThan:
+      return Compare<T, GreaterThan>(values, rows, constant, bitmap);
+    case ComparisonType::GreaterThanOrEqual:
+      return Compare<T, GreaterThanOrEqual>(values, rows, constant, bitmap);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+template void CompareWithConstant<int32_t>(ComparisonType, const int32_t *, size_t, int32_t, uint64_t *);
+template void CompareWithConstant<int64_t>(ComparisonType, const int64_t *, size_t, int64_t, uint64_t *);
+template void CompareWithConstant<double>(ComparisonType, const double *, size_t, double, uint64_t *);
+
+auto ColumnConstantFilter::Match(const AbstractExpression &expr, const Schema &schema)
+    -> std::optional<ColumnConstantFilter> {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comparison == nullptr) {
+    return std::nullopt;
+  }
+  ComparisonType comparison_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    comparison_type = Flip(comparison_type);
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0) {
+    return std::nullopt;
+  }
+  return Create(schema, column->GetColIdx(), comparison_type, constant->val_);
+}
+
+auto ColumnConstantFilter::Create(const Schema &schema, uint32_t column, ComparisonType comparison,
+                                  const Value &value) -> std::optional<ColumnConstantFilter> {
+  if (value.IsNull()) {
+    return std::nullopt;
+  }
+  ColumnConstantFilter filter;
+  filter.comparison_ = comparison;
+  filter.type_ = schema.GetColumn(column).GetType();
+  filter.offset_ = schema.GetColumn(column).GetOffset();
+  const TypeId constant_type = value.GetTypeId();
+  const bool integer_constant = constant_type == TypeId::TINYINT || constant_type == TypeId::SMALLINT ||
+                                constant_type == TypeId::INTEGER || constant_type == TypeId::BIGINT;
+  // Only take constants that convert to the type of the column without changing the result of the comparison.
+  switch (filter.type_) {
+    case TypeId::INTEGER:
+      if (!integer_constant || constant_type == TypeId::BIGINT) {
+        return std::nullopt;
+      }
+      filter.int_constant_ = value.CastAs(TypeId::INTEGER).GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      if (!integer_constant) {
+        return std::nullopt;
+      }
+      filter.int_constant_ = value.CastAs(TypeId::BIGINT).GetAs<int64_t>();
+      break;
+    case TypeId::DECIMAL:
+      if (!integer_constant && constant_type != TypeId::DECIMAL) {
+        return std::nullopt;
+      }
+      filter.decimal_constant_ = value.CastAs(TypeId::DECIMAL).GetAs<double>();
+      break;
+    default:
+      return std::nullopt;
+  }
+  return filter;
+}
+
+auto ColumnConstantFilter::Split(const AbstractExpressionRef &predicate, const Schema &schema,
+                                 std::vector<ColumnConstantFilter> *filters) -> AbstractExpressionRef {
+  std::vector<AbstractExpressionRef> terms;
+  CollectConjuncts(predicate, &terms);
+  AbstractExpressionRef rest = nullptr;
+  for (const auto &term : terms) {
+    if (auto filter = Match(*term, schema); filter.has_value()) {
+      filters->push_back(std::move(*filter));
+    } else {
+      rest = rest == nullptr ? term : std::make_shared<LogicExpression>(rest, term, LogicType::And);
+    }
+  }
+  return rest;
+}
+
+template <typename T>
+void ColumnConstantFilter::ApplyTyped(const std::vector<Tuple> &tuples, size_t rows, std::vector<T> *buffer,
+                                      T constant) {
+  buffer->resize(rows);
+  for (size_t i = 0; i < rows; i++) {
+    std::memcpy(&(*buffer)[i], tuples[i].GetData() + offset_, sizeof(T));
+  }
+  CompareWithConstant(comparison_, buffer->data(), rows, constant, result_.data());
+  if (nulls_pass_) {
+    const T null = NullOf<T>();
+    for (size_t i = 0; i < rows; i++) {
+      result_[i / 64] |= static_cast<uint64_t>((*buffer)[i] == null) << (i % 64);
+    }
+  }
+}
+
+void ColumnConstantFilter::Apply(const std::vector<Tuple> &tuples, size_t rows, uint64_t *bitmap) {
+  result_.resize(BitmapWords(rows));
+  switch (type_) {
+    case TypeId::INTEGER:
+      ApplyTyped(tuples, rows, &int32_values_, static_cast<int32_t>(int_constant_));
+      break;
+    case TypeId::BIGINT:
+      ApplyTyped(tuples, rows, &int64_values_, int_constant_);
+      break;
+    case TypeId::DECIMAL:
+      ApplyTyped(tuples, rows, &decimal_values_, decimal_constant_);
+      break;
+    default:
+      UNREACHABLE("Unsupported column type.");
+  }
+  for (size_t w = 0; w < result_.size(); w++) {
+    bitmap[w] &= result_[w];
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/gather_executor.h"
+
+#include <utility>
+
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan)
+    : AbstractExecutor(exec_ctx), plan_{std::move(plan)} {
+  push_sink_ = [this](size_t /* worker */, TupleBatch *batch) { Push(batch); };
+}
+
+GatherExecutor::~GatherExecutor() { Stop(); }
+
+auto GatherExecutor::IsParallelPipeline(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+    case PlanType::MockScan:
+      return true;
+    case PlanType::Filter:
+    case PlanType::Projection:
+      return IsParallelPipeline(*plan.GetChildAt(0));
+    default:
+      return false;
+  }
+}
+
+void GatherExecutor::Init() {
+  Stop();
+
+  const AbstractPlanNode *scan = plan_.get();
+  while (!scan->GetChildren().empty()) {
+    scan = scan->GetChildAt(0).get();
+  }
+  std::shared_ptr<MorselQueue> morsels;
+  if (scan->GetType() == PlanType::SeqScan) {
+    auto *table_info = exec_ctx_->GetCatalog()->GetTable(dynamic_cast<const SeqScanPlanNode *>(scan)->GetTableOid());
+    morsels = std::make_shared<MorselQueue>(table_info->table_->GetPageIds(), MORSEL_PAGES);
+  } else {
+    morsels = std::make_shared<MorselQueue>(GetSizeOf(dynamic_cast<const MockScanPlanNode *>(scan)), MORSEL_ROWS);
+  }
+
+  // The scans pick up the queue while they are initialized; it is only registered for that long.
+  exec_ctx_->SetMorselQueue(scan, morsels);
+  pipelines_.clear();
+  for (size_t i = 0; i < exec_ctx_->GetWorkerCount(); i++) {
+    pipelines_.push_back(std::make_unique<Pipeline>(exec_ctx_, plan_));
+    if (make_worker_operator_) {
+      pipelines_.back()->AddOperator(make_worker_operator_(i));
+    }
+    pipelines_.back()->Init();
+  }
+  exec_ctx_->SetMorselQueue(scan, nullptr);
+
+  current_.Reset(&GetOutputSchema());
+  current_row_ = 0;
+}
+
+void GatherExecutor::SetWorkerOperator(std::function<std::unique_ptr<PipelineOperator>(size_t)> make_operator,
+                                       const Schema *output_schema) {
+  make_worker_operator_ = std::move(make_operator);
+  output_schema_ = output_schema;
+}
+
+void GatherExecutor::Start(const std::function<void(size_t, TupleBatch *)> &sink) {
+  BUSTUB_ASSERT(!started_, "the pipelines of a gather can only be run once per Init");
+  started_ = true;
+  stopped_ = false;
+  running_ = pipelines_.size();
+  error_ = nullptr;
+  for (size_t i = 0; i < pipelines_.size(); i++) {
+    workers_.push_back(exec_ctx_->GetWorkerPool()->Submit([this, i, &sink] { RunPipeline(i, sink); }));
+  }
+}
+
+void GatherExecutor::Stop() {
+  {
+    std::scoped_lock lock(latch_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.wait();
+  }
+  workers_.clear();
+  batches_.clear();
+  started_ = false;
+}
+
+void GatherExecutor::RunPipeline(size_t worker, const std::function<void(size_t, TupleBatch *)> &sink) {
+  try {
+    pipelines_[worker]->Run([&](TupleBatch *batch) { sink(worker, batch); }, &stopped_);
+  } catch (...) {
+    std::scoped_lock lock(latch_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+    stopped_ = true;
+  }
+  {
+    std::scoped_lock lock(latch_);
+    running_--;
+  }
+  cv_.notify_all();
+}
+
+void GatherExecutor::Push(TupleBatch *batch) {
+  std::unique_lock lock(latch_);
+  // A couple of batches per worker keep the workers busy while the consumer is working on the last one.
+  cv_.wait(lock, [&] { return stopped_ || batches_.size() < 2 * pipelines_.size(); });
+  if (stopped_) {
+    return;
+  }
+  batches_.push_back(std::move(*batch));
+  lock.unlock();
+  cv_.notify_all();
+}
+
+void GatherExecutor::RunOnWorkers(const std::function<void(size_t, TupleBatch *)> &sink) {
+  Start(sink);
+  for (auto &worker : workers_) {
+    worker.wait();
+  }
+  workers_.clear();
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+}
+
+auto GatherExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (!started_) {
+    Start(push_sink_);
+  }
+  std::unique_lock lock(latch_);
+  cv_.wait(lock, [&] { return !batches_.empty() || running_ == 0 || error_ != nullptr; });
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  if (batches_.empty()) {
+    batch->Reset(&GetOutputSchema());
+    return false;
+  }
+  *batch = std::move(batches_.front());
+  batches_.pop_front();
+  lock.unlock();
+  cv_.notify_all();
+  return true;
+}
+
+auto GatherExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (current_row_ == current_.Size()) {
+    if (!NextBatch(&current_)) {
+      return false;
+    }
+    current_row_ = 0;
+  }
+  *tuple = current_.GetTuple(current_row_++);
+  return true;
+}
+
+}  // namespace bustub
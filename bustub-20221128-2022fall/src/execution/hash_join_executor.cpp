@@ -12,23 +12,451 @@
 
 #include "execution/executors/hash_join_executor.h"
 
-// Note for 2022 Fall: You don't need to implement HashJoinExecutor to pass all tests. You ONLY need to implement it
-// if you want to get faster in leaderboard tests.
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+/** Probes the in-memory partitions of a join on a worker of the gather of its probe side */
+class HashJoinExecutor::WorkerProbeOperator : public PipelineOperator {
+ public:
+  WorkerProbeOperator(HashJoinExecutor *join, ProbeState *state) : join_{join}, state_{state} {}
+
+  void Push(TupleBatch *batch) override { join_->ProbeBatch(state_, batch, emit_); }
+
+  void Finish() override {
+    if (state_->output_batch_.Size() != 0) {
+      emit_(&state_->output_batch_);
+    }
+  }
+
+ private:
+  HashJoinExecutor *join_;
+  ProbeState *state_;
+};
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      left_child_{std::move(left_child)},
+      right_child_{std::move(right_child)},
+      build_gather_{dynamic_cast<GatherExecutor *>(right_child_.get())} {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
+  if (auto *gather = dynamic_cast<GatherExecutor *>(left_child_.get()); gather != nullptr) {
+    ProbeOnWorkers(gather);
+  }
+}
+
+void HashJoinExecutor::ProbeOnWorkers(GatherExecutor *gather) {
+  probe_gather_ = gather;
+  gather->SetWorkerOperator(
+      [this](size_t worker) { return std::make_unique<WorkerProbeOperator>(this, &worker_probes_[worker]); },
+      &GetOutputSchema());
+}
+
+void HashJoinExecutor::Init() {
+  InitBuild([this] { left_child_->Init(); });
+  gathering_ = probe_gather_ != nullptr;
+  if (!gathering_) {
+    probe_next_ = [this](TupleBatch *batch) { return left_child_->NextBatch(batch); };
+  }
 }
 
-void HashJoinExecutor::Init() { throw NotImplementedException("HashJoinExecutor is not implemented"); }
+void HashJoinExecutor::InitBuild(const std::function<void()> &init_probe_side) {
+  // The gather creates the probe operators of its workers while it is initialized.
+  probe_ = {};
+  worker_probes_.clear();
+  if (probe_gather_ != nullptr) {
+    worker_probes_.resize(exec_ctx_->GetWorkerCount());
+  }
+  probe_.output_batch_.Reset(&GetOutputSchema());
+  for (auto &state : worker_probes_) {
+    state.output_batch_.Reset(&GetOutputSchema());
+  }
+  // The probe side scan picks up the filter while it is initialized; it is only set for that long.
+  bloom_filter_ = MakeBloomFilter();
+  init_probe_side();
+  if (bloom_filter_ != nullptr) {
+    exec_ctx_->SetBloomFilter(bloom_filter_scan_, nullptr);
+  }
+  right_child_->Init();
+  pending_passes_.clear();
+  pass_ = {};
+  output_batch_.Reset(&GetOutputSchema());
+  output_index_ = 0;
+
+  if (build_gather_ != nullptr) {
+    BuildParallel();
+  } else {
+    Build([this](TupleBatch *batch) { return right_child_->NextBatch(batch); }, 0);
+  }
+  // Only a pipeline pushes probe tuples, Init reads them from the left child instead.
+  probe_next_ = [](TupleBatch * /* batch */) { return false; };
+}
+
+auto HashJoinExecutor::MakeBloomFilter() -> std::shared_ptr<BloomFilter> {
+  // A left join keeps the left tuples without a match, so it cannot drop them.
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&plan_->LeftJoinKeyExpression());
+  if (plan_->GetJoinType() != JoinType::INNER || column_expr == nullptr) {
+    return nullptr;
+  }
+  uint32_t column = column_expr->GetColIdx();
+  const auto *scan = SeqScanExecutor::FindScanOfColumn(plan_->GetLeftPlan().get(), &column);
+  // Keys of different types can be equal with different hashes.
+  if (scan == nullptr ||
+      scan->OutputSchema().GetColumn(column).GetType() != plan_->RightJoinKeyExpression().GetReturnType()) {
+    return nullptr;
+  }
+  auto filter = std::make_shared<BloomFilter>(column, scan->OutputSchema().GetColumn(column).GetName());
+  exec_ctx_->SetBloomFilter(scan, filter);
+  bloom_filter_scan_ = scan;
+  return filter;
+}
+
+auto HashJoinExecutor::PartitionOf(hash_t hash, uint32_t depth) -> size_t {
+  // Every level partitions on the next bits of the hash, starting from the top ones, while the hash table buckets on
+  // the low ones.
+  constexpr uint32_t partition_bits = __builtin_ctzll(HASH_JOIN_PARTITIONS);
+  static_assert((HASH_JOIN_PARTITIONS & (HASH_JOIN_PARTITIONS - 1)) == 0);
+  return (hash >> (64 - (depth + 1) * partition_bits)) & (HASH_JOIN_PARTITIONS - 1);
+}
+
+auto HashJoinExecutor::StartBuild(uint32_t depth, size_t num_shards) -> std::vector<BuildShard> {
+  depth_ = depth;
+  partitions_.clear();
+  partitions_.resize(HASH_JOIN_PARTITIONS);
+  for (auto &spilled : spilled_) {
+    spilled = false;
+  }
+  std::vector<BuildShard> shards(num_shards);
+  for (auto &shard : shards) {
+    shard.partitions_.resize(HASH_JOIN_PARTITIONS);
+    for (auto &partition : shard.partitions_) {
+      partition.arena_ = Arena{exec_ctx_->GetArenaBlockPool()};
+    }
+  }
+  return shards;
+}
+
+void HashJoinExecutor::Build(const std::function<bool(TupleBatch *)> &next, uint32_t depth) {
+  auto shards = StartBuild(depth, 1);
+  TupleBatch batch{};
+  while (next(&batch)) {
+    PartitionBuildBatch(&shards[0], batch, HASH_JOIN_MEMORY_BUDGET);
+  }
+  FinishBuild(&shards);
+}
+
+void HashJoinExecutor::BuildParallel() {
+  const size_t num_workers = build_gather_->GetWorkerCount();
+  auto shards = StartBuild(0, num_workers);
+  // Every worker partitions its own batches with its share of the budget, so the workers share nothing but the flags
+  // of the spilled partitions.
+  build_gather_->RunOnWorkers([&](size_t worker, TupleBatch *batch) {
+    PartitionBuildBatch(&shards[worker], *batch, HASH_JOIN_MEMORY_BUDGET / num_workers);
+  });
+  FinishBuild(&shards);
+}
+
+void HashJoinExecutor::PartitionBuildBatch(BuildShard *shard, const TupleBatch &batch, size_t memory_budget) {
+  constexpr uint32_t partition_bits = __builtin_ctzll(HASH_JOIN_PARTITIONS);
+  // Past this depth the low hash bits would be reused. A partition that is still too big then has so many tuples with
+  // the same key that partitioning cannot split it, so it is joined in memory.
+  const bool can_spill = (depth_ + 1) * partition_bits <= 32;
+  const bool collect_hashes = depth_ == 0 && bloom_filter_ != nullptr;
+
+  plan_->RightJoinKeyExpression().EvaluateBatch(batch, &shard->keys_);
+  for (size_t row = 0; row < batch.Size(); row++) {
+    if (shard->keys_[row].IsNull()) {
+      // NULL never equals anything, so the tuple cannot be part of the result.
+      continue;
+    }
+    auto hash = HashJoinKey(shard->keys_[row]);
+    if (collect_hashes) {
+      shard->hashes_.push_back(hash);
+    }
+    auto partition_index = PartitionOf(hash, depth_);
+    auto &partition = shard->partitions_[partition_index];
+    if (spilled_[partition_index].load(std::memory_order_relaxed)) {
+      // Another shard may have spilled the partition; this one follows as soon as it sees it.
+      shard->memory_usage_ -= SpillBuildPartition(&partition);
+      partition.spilled_->Append(batch.GetTuple(row));
+      continue;
+    }
+    partition.tuples_.emplace_back(hash, batch.GetTuple(row, &partition.arena_));
+    auto tuple_size = sizeof(std::pair<hash_t, Tuple>) + partition.tuples_.back().second.GetLength();
+    partition.memory_usage_ += tuple_size;
+    shard->memory_usage_ += tuple_size;
+
+    while (can_spill && shard->memory_usage_ > memory_budget) {
+      // Spilling the largest partition frees the most memory for the ones that stay.
+      auto victim = std::max_element(shard->partitions_.begin(), shard->partitions_.end(),
+                                     [](const auto &a, const auto &b) { return a.memory_usage_ < b.memory_usage_; });
+      spilled_[victim - shard->partitions_.begin()].store(true, std::memory_order_relaxed);
+      shard->memory_usage_ -= SpillBuildPartition(&*victim);
+    }
+  }
+}
+
+auto HashJoinExecutor::SpillBuildPartition(BuildPartition *partition) -> size_t {
+  if (partition->spilled_ == nullptr) {
+    partition->spilled_ = std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager());
+  }
+  if (partition->tuples_.empty()) {
+    return 0;
+  }
+  for (const auto &[_, tuple] : partition->tuples_) {
+    partition->spilled_->Append(tuple);
+  }
+  partition->tuples_ = {};
+  partition->arena_.Reset();
+  return std::exchange(partition->memory_usage_, 0);
+}
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+void HashJoinExecutor::FinishBuild(std::vector<BuildShard> *shards) {
+  if (depth_ == 0 && bloom_filter_ != nullptr) {
+    std::vector<hash_t> build_hashes = std::move((*shards)[0].hashes_);
+    for (size_t i = 1; i < shards->size(); i++) {
+      build_hashes.insert(build_hashes.end(), (*shards)[i].hashes_.begin(), (*shards)[i].hashes_.end());
+    }
+    bloom_filter_->Build(build_hashes);
+    bloom_filter_->Publish();
+  }
+
+  // Every partition is merged by one task, which is the only one touching the partition in any of the shards.
+  auto merge_partition = [&](size_t index) {
+    auto &partition = partitions_[index];
+    if (spilled_[index]) {
+      partition.spilled_build_ = std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager());
+      for (auto &shard : *shards) {
+        auto &shard_partition = shard.partitions_[index];
+        SpillBuildPartition(&shard_partition);
+        shard_partition.spilled_->FinishAppend();
+        partition.spilled_build_->Absorb(shard_partition.spilled_.get());
+      }
+      return;
+    }
+    size_t num_tuples = 0;
+    for (const auto &shard : *shards) {
+      num_tuples += shard.partitions_[index].tuples_.size();
+    }
+    partition.table_.reserve(num_tuples);
+    for (auto &shard : *shards) {
+      auto &shard_partition = shard.partitions_[index];
+      for (auto &[hash, tuple] : shard_partition.tuples_) {
+        partition.table_.emplace(hash, std::move(tuple));
+      }
+      shard_partition.tuples_ = {};
+      partition.arenas_.push_back(std::move(shard_partition.arena_));
+    }
+  };
+  auto *worker_pool = exec_ctx_->GetWorkerPool();
+  if (worker_pool != nullptr && exec_ctx_->GetWorkerCount() > 1) {
+    worker_pool->ParallelFor(HASH_JOIN_PARTITIONS, merge_partition);
+  } else {
+    for (size_t i = 0; i < HASH_JOIN_PARTITIONS; i++) {
+      merge_partition(i);
+    }
+  }
+}
+
+auto HashJoinExecutor::NextProbeBatch() -> bool {
+  probe_.probe_row_ = 0;
+  do {
+    while (!probe_next_(&probe_.probe_batch_)) {
+      if (!StartNextPass()) {
+        return false;
+      }
+    }
+  } while (probe_.probe_batch_.Size() == 0);
+  plan_->LeftJoinKeyExpression().EvaluateBatch(probe_.probe_batch_, &probe_.probe_keys_);
+  StartProbeRow(&probe_);
+  return true;
+}
+
+void HashJoinExecutor::StartProbeRow(ProbeState *state) {
+  state->match_begin_ = state->match_end_ = {};
+  state->pad_probe_row_ = plan_->GetJoinType() == JoinType::LEFT;
+  const auto &key = state->probe_keys_[state->probe_row_];
+  if (key.IsNull()) {
+    return;
+  }
+  auto hash = HashJoinKey(key);
+  auto partition_index = PartitionOf(hash, depth_);
+  const auto &partition = partitions_[partition_index];
+  if (partition.spilled_build_ != nullptr) {
+    // The row is joined, or padded, when its partition is.
+    if (state->spilled_probe_.empty()) {
+      state->spilled_probe_.resize(HASH_JOIN_PARTITIONS);
+    }
+    auto &spilled_probe = state->spilled_probe_[partition_index];
+    if (spilled_probe == nullptr) {
+      spilled_probe = std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager());
+    }
+    spilled_probe->Append(state->probe_batch_.GetTuple(state->probe_row_));
+    state->pad_probe_row_ = false;
+    return;
+  }
+  std::tie(state->match_begin_, state->match_end_) = partition.table_.equal_range(hash);
+}
+
+auto HashJoinExecutor::FillBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (probe_.probe_row_ == probe_.probe_batch_.Size() && !NextProbeBatch()) {
+      break;
+    }
+    JoinProbeRows(&probe_, batch);
+  }
+  return batch->Size() != 0;
+}
+
+void HashJoinExecutor::JoinProbeRows(ProbeState *state, TupleBatch *batch) {
+  const auto &right_schema = right_child_->GetOutputSchema();
+  while (!batch->IsFull() && state->probe_row_ < state->probe_batch_.Size()) {
+    const auto &key = state->probe_keys_[state->probe_row_];
+    for (; state->match_begin_ != state->match_end_ && !batch->IsFull(); ++state->match_begin_) {
+      auto right_key = plan_->RightJoinKeyExpression().Evaluate(&state->match_begin_->second, right_schema);
+      if (key.CompareEquals(right_key) == CmpBool::CmpTrue) {
+        AppendOutputRow(state, batch, &state->match_begin_->second);
+        state->pad_probe_row_ = false;
+      }
+    }
+    if (state->match_begin_ != state->match_end_) {
+      break;
+    }
+    if (state->pad_probe_row_) {
+      AppendOutputRow(state, batch, nullptr);
+    }
+    if (++state->probe_row_ < state->probe_batch_.Size()) {
+      StartProbeRow(state);
+    }
+  }
+}
+
+void HashJoinExecutor::ProbeBatch(ProbeState *state, TupleBatch *probe,
+                                  const std::function<void(TupleBatch *)> &emit) {
+  std::swap(state->probe_batch_, *probe);
+  state->probe_row_ = 0;
+  if (state->probe_batch_.Size() == 0) {
+    return;
+  }
+  plan_->LeftJoinKeyExpression().EvaluateBatch(state->probe_batch_, &state->probe_keys_);
+  StartProbeRow(state);
+  while (true) {
+    JoinProbeRows(state, &state->output_batch_);
+    if (!state->output_batch_.IsFull()) {
+      break;
+    }
+    emit(&state->output_batch_);
+    state->output_batch_.Reset(&GetOutputSchema());
+  }
+}
+
+void HashJoinExecutor::Probe(TupleBatch *probe, const std::function<void(TupleBatch *)> &emit) {
+  if (probe_gather_ != nullptr) {
+    // The workers of the gather joined the batch already.
+    emit(probe);
+    return;
+  }
+  ProbeBatch(&probe_, probe, emit);
+}
+
+void HashJoinExecutor::FinishProbe(const std::function<void(TupleBatch *)> &emit) {
+  if (probe_.output_batch_.Size() != 0) {
+    emit(&probe_.output_batch_);
+  }
+  // The probe tuples of the spilled partitions are read back pass by pass, as when pulling from the left child.
+  while (FillBatch(&output_batch_)) {
+    emit(&output_batch_);
+  }
+}
+
+auto HashJoinExecutor::StartNextPass() -> bool {
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    if (partitions_[i].spilled_build_ == nullptr) {
+      continue;
+    }
+    // The probe tuples every thread spilled for the partition are read back as one.
+    auto probe = std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager());
+    auto absorb_spilled_probe = [&](ProbeState *state) {
+      if (!state->spilled_probe_.empty() && state->spilled_probe_[i] != nullptr) {
+        state->spilled_probe_[i]->FinishAppend();
+        probe->Absorb(state->spilled_probe_[i].get());
+      }
+    };
+    absorb_spilled_probe(&probe_);
+    for (auto &state : worker_probes_) {
+      absorb_spilled_probe(&state);
+    }
+    if (probe->Size() == 0) {
+      continue;
+    }
+    pending_passes_.push_back({std::move(partitions_[i].spilled_build_), std::move(probe), depth_ + 1});
+  }
+  partitions_.clear();
+  probe_.spilled_probe_.clear();
+  worker_probes_.clear();
+  if (pending_passes_.empty()) {
+    return false;
+  }
+
+  pass_ = std::move(pending_passes_.back());
+  pending_passes_.pop_back();
+  Build([this](TupleBatch *batch) { return pass_.build_->NextBatch(&right_child_->GetOutputSchema(), batch); },
+        pass_.depth_);
+  probe_next_ = [this](TupleBatch *batch) {
+    return pass_.probe_->NextBatch(&plan_->GetLeftPlan()->OutputSchema(), batch);
+  };
+  return true;
+}
+
+void HashJoinExecutor::AppendOutputRow(ProbeState *state, TupleBatch *batch, const Tuple *right_tuple) {
+  const auto &left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const auto &right_schema = right_child_->GetOutputSchema();
+  state->output_values_.clear();
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    state->output_values_.push_back(state->probe_batch_.GetValue(state->probe_row_, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    state->output_values_.push_back(right_tuple != nullptr
+                                        ? right_tuple->GetValue(&right_schema, i)
+                                        : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+  batch->AppendRow(std::move(state->output_values_));
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (output_index_ == output_batch_.Size()) {
+    if (!NextBatch(&output_batch_)) {
+      return false;
+    }
+    output_index_ = 0;
+  }
+  *tuple = output_batch_.GetTuple(output_index_++);
+  return true;
+}
+
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  // The workers of the probe side gather join the partitions in memory, the spilled ones are joined afterwards.
+  while (gathering_) {
+    if (!left_child_->NextBatch(batch)) {
+      gathering_ = false;
+    } else if (batch->Size() != 0) {
+      return true;
+    }
+  }
+  return FillBatch(batch);
+}
 
 }  // namespace bustub
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_child,
+                                     std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      left_child_{std::move(left_child)},
+      right_child_{std::move(right_child)},
+      group_arena_{exec_ctx->GetArenaBlockPool()} {
+  if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
+    throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
+  }
+}
+
+void MergeJoinExecutor::Init() {
+  left_child_->Init();
+  right_child_->Init();
+  left_batch_.Reset(&left_child_->GetOutputSchema());
+  left_row_ = 0;
+  left_row_started_ = false;
+  left_done_ = false;
+  right_batch_.Reset(&right_child_->GetOutputSchema());
+  right_row_ = 0;
+  right_done_ = false;
+  group_key_.reset();
+  group_.clear();
+  group_matches_ = false;
+  output_batch_.Reset(&GetOutputSchema());
+  output_index_ = 0;
+}
+
+auto MergeJoinExecutor::RightRowValid() -> bool {
+  while (!right_done_ && right_row_ == right_batch_.Size()) {
+    if (!right_child_->NextBatch(&right_batch_)) {
+      right_done_ = true;
+      break;
+    }
+    plan_->RightJoinKeyExpression().EvaluateBatch(right_batch_, &right_keys_);
+    right_row_ = 0;
+  }
+  return !right_done_;
+}
+
+void MergeJoinExecutor::StartLeftRow() {
+  const Value &key = left_keys_[left_row_];
+  group_index_ = 0;
+  group_matches_ = false;
+  if (key.IsNull()) {
+    // NULL never equals anything, so the row has no match.
+    return;
+  }
+  if (group_key_.has_value() && key.CompareEquals(*group_key_) == CmpBool::CmpTrue) {
+    // A duplicate left key joins with the group collected for the previous row.
+    group_matches_ = true;
+    return;
+  }
+
+  // Both inputs are ascending with nulls first, so the right rows before the key cannot match any later left row.
+  while (RightRowValid() &&
+         (right_keys_[right_row_].IsNull() || right_keys_[right_row_].CompareLessThan(key) == CmpBool::CmpTrue)) {
+    right_row_++;
+  }
+  group_key_.reset();
+  group_.clear();
+  group_arena_.Reset();
+  while (RightRowValid() && right_keys_[right_row_].CompareEquals(key) == CmpBool::CmpTrue) {
+    group_.emplace_back(right_batch_.GetTuple(right_row_, &group_arena_));
+    right_row_++;
+  }
+  if (!group_.empty()) {
+    group_key_ = key;
+    group_matches_ = true;
+  }
+}
+
+auto MergeJoinExecutor::FillBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!left_done_ && !batch->IsFull()) {
+    if (left_row_ == left_batch_.Size()) {
+      if (!left_child_->NextBatch(&left_batch_)) {
+        left_done_ = true;
+        break;
+      }
+      plan_->LeftJoinKeyExpression().EvaluateBatch(left_batch_, &left_keys_);
+      left_row_ = 0;
+      continue;
+    }
+    if (!left_row_started_) {
+      StartLeftRow();
+      left_row_started_ = true;
+    }
+    if (group_matches_) {
+      while (group_index_ < group_.size() && !batch->IsFull()) {
+        AppendOutputRow(batch, &group_[group_index_++]);
+      }
+      if (group_index_ < group_.size()) {
+        break;
+      }
+    } else if (plan_->GetJoinType() == JoinType::LEFT) {
+      AppendOutputRow(batch, nullptr);
+    }
+    left_row_++;
+    left_row_started_ = false;
+  }
+  return batch->Size() > 0;
+}
+
+void MergeJoinExecutor::AppendOutputRow(TupleBatch *batch, const Tuple *right_tuple) {
+  const auto &left_schema = left_child_->GetOutputSchema();
+  const auto &right_schema = right_child_->GetOutputSchema();
+  output_values_.clear();
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    output_values_.push_back(left_batch_.GetValue(left_row_, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    output_values_.push_back(right_tuple != nullptr
+                                 ? right_tuple->GetValue(&right_schema, i)
+                                 : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+  batch->AppendRow(std::move(output_values_));
+}
+
+auto MergeJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (output_index_ == output_batch_.Size()) {
+    if (!FillBatch(&output_batch_)) {
+      return false;
+    }
+    output_index_ = 0;
+  }
+  *tuple = output_batch_.GetTuple(output_index_++);
+  return true;
+}
+
+auto MergeJoinExecutor::NextBatch(TupleBatch *batch) -> bool { return FillBatch(batch); }
+
+}  // namespace bustub
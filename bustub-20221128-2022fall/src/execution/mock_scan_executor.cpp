@@ -183,32 +183,32 @@ auto GetShuffled(const MockScanPlanNode *plan) -> bool {
   return false;
 }
 
-auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)> {
+auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<std::vector<Value>(size_t)> {
   const auto &table = plan->GetTable();
 
   if (table == "__mock_table_1") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.reserve(2);
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 100));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_2") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.reserve(2);
       values.push_back(ValueFactory::GetVarcharValue(fmt::format("{}-\U0001F4A9", cursor)));  // the poop emoji
       values.push_back(
           ValueFactory::GetVarcharValue(StringUtil::Repeat("\U0001F607", cursor % 8)));  // the innocent emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_3") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.reserve(2);
       if (cursor % 2 == 0) {
@@ -217,30 +217,30 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
         values.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
       }
       values.push_back(ValueFactory::GetVarcharValue(fmt::format("{}-\U0001F4A9", cursor)));  // the poop emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_tas_2022") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetVarcharValue(ta_list_2022[cursor]));
       values.push_back(ValueFactory::GetVarcharValue(ta_oh_2022[cursor]));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_schedule_2022") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetVarcharValue(course_on_date[cursor]));
       values.push_back(ValueFactory::GetIntegerValue(course_on_bool[cursor]));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_agg_input_small") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue((cursor + 2) % 10));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
@@ -249,12 +249,12 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
       values.push_back(ValueFactory::GetIntegerValue(233));
       values.push_back(
           ValueFactory::GetVarcharValue(StringUtil::Repeat("\U0001F4A9", (cursor % 8) + 1)));  // the poop emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_agg_input_big") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue((cursor + 2) % 10));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
@@ -263,20 +263,20 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
       values.push_back(ValueFactory::GetIntegerValue(233));
       values.push_back(
           ValueFactory::GetVarcharValue(StringUtil::Repeat("\U0001F4A9", (cursor % 16) + 1)));  // the poop emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_123") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor + 1));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_graph") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       int src = cursor % GRAPH_NODE_CNT;
       int dst = cursor / GRAPH_NODE_CNT;
@@ -289,82 +289,82 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
       } else {
         values.push_back(ValueFactory::GetIntegerValue(1));
       }
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t1_50k") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 1000));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t2_100k") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 100));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t3_1k") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor * 100));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10000));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t4_1m") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       cursor = cursor % 500000;
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t5_1m") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       cursor = (cursor + 30000) % 500000;
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t6_1m") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       cursor = (cursor + 60000) % 500000;
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t7") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor % 20));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t8") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
@@ -375,7 +375,7 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
     for (const auto &column : plan->OutputSchema().GetColumns()) {
       values.push_back(ValueFactory::GetZeroValueByType(column.GetType()));
     }
-    return Tuple{values, &plan->OutputSchema()};
+    return values;
   };
 }
 
@@ -394,23 +394,39 @@ MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlan
 void MockScanExecutor::Init() {
   // Reset the cursor
   cursor_ = 0;
+  morsels_ = exec_ctx_->GetMorselQueue(plan_);
+  end_ = morsels_ == nullptr ? size_ : 0;
+}
+
+auto MockScanExecutor::Advance() -> bool {
+  return cursor_ < end_ || (morsels_ != nullptr && morsels_->Next(&cursor_, &end_));
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (cursor_ == size_) {
+  if (!Advance()) {
     // Scan complete
     return EXECUTOR_EXHAUSTED;
   }
-  if (shuffled_idx_.empty()) {
-    *tuple = func_(cursor_);
+  // Each instance of a parallel scan shuffles differently, so the shuffled order only applies to a serial scan.
+  if (shuffled_idx_.empty() || morsels_ != nullptr) {
+    *tuple = Tuple{func_(cursor_), &GetOutputSchema()};
   } else {
-    *tuple = func_(shuffled_idx_[cursor_]);
+    *tuple = Tuple{func_(shuffled_idx_[cursor_]), &GetOutputSchema()};
   }
   ++cursor_;
   *rid = MakeDummyRID();
   return EXECUTOR_ACTIVE;
 }
 
+auto MockScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  const bool shuffled = !shuffled_idx_.empty() && morsels_ == nullptr;
+  for (; !batch->IsFull() && Advance(); ++cursor_) {
+    batch->AppendRow(func_(shuffled ? shuffled_idx_[cursor_] : cursor_));
+  }
+  return batch->Size() != 0;
+}
+
 auto MockScanExecutor::MakeDummyRID() -> RID { return RID{0}; }
 
 }  // namespace bustub
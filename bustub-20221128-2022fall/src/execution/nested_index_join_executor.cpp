@@ -12,19 +12,137 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include <algorithm>
+
+#include "type/value_factory.h"
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      child_executor_{std::move(child_executor)},
+      outer_arena_{exec_ctx->GetArenaBlockPool()} {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  outer_batch_.Reset(&child_executor_->GetOutputSchema());
+  outer_tuples_.clear();
+  outer_done_ = false;
+  row_matches_.clear();
+  outer_row_ = 0;
+  match_index_ = 0;
+  output_batch_.Reset(&GetOutputSchema());
+  output_index_ = 0;
+}
+
+auto NestIndexJoinExecutor::ProbeOuterBatch() -> bool {
+  if (outer_done_ || !child_executor_->NextBatch(&outer_batch_)) {
+    outer_done_ = true;
+    return false;
+  }
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto rows = outer_batch_.Size();
+  outer_tuples_.clear();
+  outer_arena_.Reset();
+  keys_.clear();
+  sorted_rows_.clear();
+  for (uint32_t row = 0; row < rows; row++) {
+    const auto &tuple = outer_tuples_.emplace_back(outer_batch_.GetTuple(row, &outer_arena_));
+    const auto &key = keys_.emplace_back(plan_->KeyPredicate()->Evaluate(&tuple, outer_schema));
+    // A null key equals nothing, so it is not looked up.
+    if (!key.IsNull()) {
+      sorted_rows_.push_back(row);
+    }
+  }
+  std::sort(sorted_rows_.begin(), sorted_rows_.end(), [this](uint32_t a, uint32_t b) {
+    return keys_[a].CompareLessThan(keys_[b]) == CmpBool::CmpTrue;
+  });
+
+  inner_tuples_.clear();
+  row_matches_.assign(rows, {0, 0});
+  const auto &key_schema = index_info_->key_schema_;
+  for (size_t i = 0; i < sorted_rows_.size(); i++) {
+    const auto row = sorted_rows_[i];
+    if (i > 0 && keys_[row].CompareEquals(keys_[sorted_rows_[i - 1]]) == CmpBool::CmpTrue) {
+      row_matches_[row] = row_matches_[sorted_rows_[i - 1]];
+      continue;
+    }
+    rids_.clear();
+    index_info_->index_->ScanKey(Tuple{{keys_[row]}, &key_schema}, &rids_, exec_ctx_->GetTransaction());
+    const auto begin = inner_tuples_.size();
+    for (const auto &rid : rids_) {
+      if (!table_info_->table_->GetTuple(rid, &inner_tuples_.emplace_back(), exec_ctx_->GetTransaction())) {
+        inner_tuples_.pop_back();
+      }
+    }
+    row_matches_[row] = {begin, inner_tuples_.size()};
+  }
+  outer_row_ = 0;
+  match_index_ = 0;
+  return true;
+}
+
+auto NestIndexJoinExecutor::FillBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (outer_row_ == outer_tuples_.size()) {
+      if (!ProbeOuterBatch()) {
+        break;
+      }
+      continue;
+    }
+    const auto [begin, end] = row_matches_[outer_row_];
+    if (begin == end) {
+      if (plan_->GetJoinType() == JoinType::LEFT) {
+        AppendOutputRow(batch, outer_tuples_[outer_row_], nullptr);
+      }
+      outer_row_++;
+      continue;
+    }
+    AppendOutputRow(batch, outer_tuples_[outer_row_], &inner_tuples_[begin + match_index_]);
+    if (++match_index_ == end - begin) {
+      match_index_ = 0;
+      outer_row_++;
+    }
+  }
+  return batch->Size() > 0;
+}
+
+void NestIndexJoinExecutor::AppendOutputRow(TupleBatch *batch, const Tuple &outer_tuple, const Tuple *inner_tuple) {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  output_values_.clear();
+  for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+    output_values_.push_back(outer_tuple.GetValue(&outer_schema, i));
+  }
+  for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+    output_values_.push_back(inner_tuple != nullptr
+                                 ? inner_tuple->GetValue(&inner_schema, i)
+                                 : ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+  }
+  batch->AppendRow(std::move(output_values_));
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (output_index_ == output_batch_.Size()) {
+    if (!FillBatch(&output_batch_)) {
+      return false;
+    }
+    output_index_ = 0;
+  }
+  *tuple = output_batch_.GetTuple(output_index_++);
+  return true;
+}
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto NestIndexJoinExecutor::NextBatch(TupleBatch *batch) -> bool { return FillBatch(batch); }
 
 }  // namespace bustub
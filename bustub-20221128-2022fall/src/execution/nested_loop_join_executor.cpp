@@ -13,21 +13,151 @@
 #include "execution/executors/nested_loop_join_executor.h"
 #include "binder/table_ref/bound_join_ref.h"
 #include "common/exception.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      left_executor_{std::move(left_executor)},
+      right_executor_{std::move(right_executor)},
+      block_arena_{exec_ctx->GetArenaBlockPool()},
+      right_arena_{exec_ctx->GetArenaBlockPool()} {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestedLoopJoinExecutor::Init() { throw NotImplementedException("NestedLoopJoinExecutor is not implemented"); }
+void NestedLoopJoinExecutor::Init() {
+  left_executor_->Init();
+  block_.clear();
+  block_matched_.clear();
+  left_batch_.Reset(&left_executor_->GetOutputSchema());
+  left_row_ = 0;
+  left_done_ = false;
+  right_batch_.Reset(&right_executor_->GetOutputSchema());
+  right_tuples_.clear();
+  right_done_ = true;
+  right_row_ = 0;
+  block_index_ = 0;
+  pad_index_ = 0;
+  output_batch_.Reset(&GetOutputSchema());
+  output_index_ = 0;
+}
+
+auto NestedLoopJoinExecutor::LoadBlock() -> bool {
+  const size_t budget = exec_ctx_->GetNLJBlockPages() * BUSTUB_PAGE_SIZE;
+  size_t memory_usage = 0;
+  block_.clear();
+  block_arena_.Reset();
+  while (!left_done_ && memory_usage < budget) {
+    if (left_row_ == left_batch_.Size()) {
+      left_done_ = !left_executor_->NextBatch(&left_batch_);
+      left_row_ = 0;
+      continue;
+    }
+    const auto &tuple = block_.emplace_back(left_batch_.GetTuple(left_row_++, &block_arena_));
+    memory_usage += sizeof(Tuple) + tuple.GetLength();
+  }
+  if (block_.empty()) {
+    return false;
+  }
+  block_matched_.assign(block_.size(), false);
+  right_executor_->Init();
+  right_done_ = false;
+  right_tuples_.clear();
+  right_row_ = 0;
+  block_index_ = 0;
+  pad_index_ = 0;
+  return true;
+}
+
+auto NestedLoopJoinExecutor::NextRightBatch() -> bool {
+  if (!right_executor_->NextBatch(&right_batch_)) {
+    right_done_ = true;
+    return false;
+  }
+  // The tuples are built once per batch, and compared with every tuple of the block.
+  right_tuples_.clear();
+  right_tuples_.reserve(right_batch_.Size());
+  right_arena_.Reset();
+  for (size_t i = 0; i < right_batch_.Size(); i++) {
+    right_tuples_.emplace_back(right_batch_.GetTuple(i, &right_arena_));
+  }
+  right_row_ = 0;
+  block_index_ = 0;
+  return true;
+}
+
+auto NestedLoopJoinExecutor::FillBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  while (!batch->IsFull()) {
+    if (!right_done_) {
+      if (right_row_ == right_tuples_.size()) {
+        NextRightBatch();
+        continue;
+      }
+      const auto &right_tuple = right_tuples_[right_row_];
+      for (; block_index_ < block_.size() && !batch->IsFull(); block_index_++) {
+        auto value = plan_->Predicate().EvaluateJoin(&block_[block_index_], left_schema, &right_tuple, right_schema);
+        if (!value.IsNull() && value.GetAs<bool>()) {
+          block_matched_[block_index_] = true;
+          AppendOutputRow(batch, block_[block_index_], &right_tuple);
+        }
+      }
+      if (block_index_ == block_.size()) {
+        block_index_ = 0;
+        right_row_++;
+      }
+      continue;
+    }
+    // The scan of the right child is done for the block, so the left tuples without a match are known.
+    if (plan_->GetJoinType() == JoinType::LEFT && pad_index_ < block_.size()) {
+      if (!block_matched_[pad_index_]) {
+        AppendOutputRow(batch, block_[pad_index_], nullptr);
+      }
+      pad_index_++;
+      continue;
+    }
+    if (!LoadBlock()) {
+      break;
+    }
+  }
+  return batch->Size() > 0;
+}
+
+void NestedLoopJoinExecutor::AppendOutputRow(TupleBatch *batch, const Tuple &left_tuple, const Tuple *right_tuple) {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  output_values_.clear();
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    output_values_.push_back(left_tuple.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    output_values_.push_back(right_tuple != nullptr
+                                 ? right_tuple->GetValue(&right_schema, i)
+                                 : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+  batch->AppendRow(std::move(output_values_));
+}
+
+auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (output_index_ == output_batch_.Size()) {
+    if (!FillBatch(&output_batch_)) {
+      return false;
+    }
+    output_index_ = 0;
+  }
+  *tuple = output_batch_.GetTuple(output_index_++);
+  return true;
+}
 
-auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) -> bool { return FillBatch(batch); }
 
 }  // namespace bustub
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pipeline.cpp
+//
+// Identification: src/execution/pipeline.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/pipeline.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "execution/compiled_expression.h"
+#include "execution/executor_factory.h"
+#include "execution/executors/filter_executor.h"
+#include "execution/executors/gather_executor.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/projection_executor.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/projection_plan.h"
+
+namespace bustub {
+
+namespace {
+
+/** Narrows the batches down to the rows that satisfy the predicate */
+class FilterOperator : public PipelineOperator {
+ public:
+  explicit FilterOperator(const FilterPlanNode *plan) : plan_{plan} {}
+
+  void Init(const std::function<void()> &init_below) override {
+    compiled_predicate_ = CompiledExpression::Compile(*plan_->GetPredicate());
+    init_below();
+  }
+
+  void Push(TupleBatch *batch) override {
+    if (FilterExecutor::FilterBatch(*plan_, compiled_predicate_.get(), batch)) {
+      emit_(batch);
+    }
+  }
+
+ private:
+  const FilterPlanNode *plan_;
+  std::unique_ptr<CompiledExpression> compiled_predicate_;
+};
+
+/** Computes the expressions over the batches */
+class ProjectionOperator : public PipelineOperator {
+ public:
+  explicit ProjectionOperator(const ProjectionPlanNode *plan) : plan_{plan} {}
+
+  void Init(const std::function<void()> &init_below) override {
+    compiled_exprs_.clear();
+    for (const auto &expr : plan_->GetExpressions()) {
+      compiled_exprs_.push_back(CompiledExpression::Compile(*expr));
+    }
+    init_below();
+  }
+
+  void Push(TupleBatch *batch) override {
+    ProjectionExecutor::ProjectBatch(*plan_, compiled_exprs_, *batch, &output_);
+    emit_(&output_);
+  }
+
+ private:
+  const ProjectionPlanNode *plan_;
+  std::vector<std::unique_ptr<CompiledExpression>> compiled_exprs_;
+  TupleBatch output_{};
+};
+
+/** Probes the hash table of a join, which builds it from its right child while the operator is initialized */
+class HashProbeOperator : public PipelineOperator {
+ public:
+  explicit HashProbeOperator(std::unique_ptr<HashJoinExecutor> join) : join_{std::move(join)} {}
+
+  void Init(const std::function<void()> &init_below) override { join_->InitBuild(init_below); }
+
+  void Push(TupleBatch *batch) override { join_->Probe(batch, emit_); }
+
+  void Finish() override { join_->FinishProbe(emit_); }
+
+ private:
+  std::unique_ptr<HashJoinExecutor> join_;
+};
+
+}  // namespace
+
+Pipeline::Pipeline(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan) : plan_{std::move(plan)} {
+  auto node = plan_;
+  while (source_ == nullptr) {
+    switch (node->GetType()) {
+      case PlanType::Filter:
+        operators_.push_back(std::make_unique<FilterOperator>(dynamic_cast<const FilterPlanNode *>(node.get())));
+        node = node->GetChildAt(0);
+        break;
+      case PlanType::Projection:
+        operators_.push_back(
+            std::make_unique<ProjectionOperator>(dynamic_cast<const ProjectionPlanNode *>(node.get())));
+        node = node->GetChildAt(0);
+        break;
+      case PlanType::HashJoin: {
+        const auto *join_plan = dynamic_cast<const HashJoinPlanNode *>(node.get());
+        auto right = ExecutorFactory::CreateBreakerInput(exec_ctx, join_plan->GetRightPlan());
+        auto join = std::make_unique<HashJoinExecutor>(exec_ctx, join_plan, nullptr, std::move(right));
+        node = join_plan->GetLeftPlan();
+        // As when the join pulls from it, a probe side that can run in parallel is gathered from all workers, which
+        // probe the hash table themselves.
+        if (exec_ctx->GetWorkerCount() > 1 && GatherExecutor::IsParallelPipeline(*node)) {
+          auto gather = std::make_unique<GatherExecutor>(exec_ctx, node);
+          join->ProbeOnWorkers(gather.get());
+          source_ = std::move(gather);
+        }
+        operators_.push_back(std::make_unique<HashProbeOperator>(std::move(join)));
+        break;
+      }
+      default:
+        source_ = ExecutorFactory::CreateExecutor(exec_ctx, node);
+    }
+  }
+  std::reverse(operators_.begin(), operators_.end());
+  for (size_t i = 0; i < operators_.size(); i++) {
+    operators_[i]->SetEmit([this, i](TupleBatch *batch) { Emit(i + 1, batch); });
+  }
+}
+
+Pipeline::~Pipeline() = default;
+
+void Pipeline::AddOperator(std::unique_ptr<PipelineOperator> op) {
+  op->SetEmit([this, i = operators_.size()](TupleBatch *batch) { Emit(i + 1, batch); });
+  operators_.push_back(std::move(op));
+}
+
+void Pipeline::Init() {
+  // Every operator initializes the ones below it, so a join sets up the Bloom filter for the scan of the source before
+  // the scan is initialized, and builds its hash table afterwards.
+  std::function<void()> init = [this] { source_->Init(); };
+  for (auto &op : operators_) {
+    init = [op = op.get(), init_below = std::move(init)] { op->Init(init_below); };
+  }
+  init();
+}
+
+void Pipeline::Run(const std::function<void(TupleBatch *)> &sink, const std::atomic<bool> *stop) {
+  sink_ = &sink;
+  TupleBatch batch{};
+  while ((stop == nullptr || !*stop) && source_->NextBatch(&batch)) {
+    Emit(0, &batch);
+  }
+  if (stop == nullptr || !*stop) {
+    for (auto &op : operators_) {
+      op->Finish();
+    }
+  }
+  sink_ = nullptr;
+}
+
+void Pipeline::Emit(size_t op, TupleBatch *batch) {
+  if (op == operators_.size()) {
+    (*sink_)(batch);
+  } else {
+    operators_[op]->Push(batch);
+  }
+}
+
+}  // namespace bustub
@@ -10,6 +10,10 @@ ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const Projecti
 void ProjectionExecutor::Init() {
   // Initialize the child executor
   child_executor_->Init();
+  compiled_exprs_.clear();
+  for (const auto &expr : plan_->GetExpressions()) {
+    compiled_exprs_.push_back(CompiledExpression::Compile(*expr));
+  }
 }
 
 auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -33,4 +37,28 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+  ProjectBatch(*plan_, compiled_exprs_, child_batch_, batch);
+  return true;
+}
+
+void ProjectionExecutor::ProjectBatch(const ProjectionPlanNode &plan,
+                                      const std::vector<std::unique_ptr<CompiledExpression>> &compiled_exprs,
+                                      const TupleBatch &input, TupleBatch *output) {
+  output->Reset(&plan.OutputSchema());
+  const auto &exprs = plan.GetExpressions();
+  for (uint32_t i = 0; i < exprs.size(); i++) {
+    std::vector<Value> values{};
+    if (compiled_exprs[i] != nullptr) {
+      compiled_exprs[i]->EvaluateBatch(input, &values);
+    } else {
+      exprs[i]->EvaluateBatch(input, &values);
+    }
+    output->SetColumn(i, std::move(values));
+  }
+}
 }  // namespace bustub
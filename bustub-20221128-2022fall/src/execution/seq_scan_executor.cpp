@@ -1,23 +1,186 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <utility>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_{plan} {}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  morsels_ = exec_ctx_->GetMorselQueue(plan_);
+  if (morsels_ == nullptr) {
+    // A scan on its own reads the table page by page as well, from a queue no other scan takes from. That fetches
+    // each page once instead of twice per tuple as the table iterator does.
+    morsels_ = std::make_shared<MorselQueue>(table_info_->table_->GetPageIds(), MORSEL_PAGES);
+  }
+  morsel_page_ = 0;
+  morsel_end_ = 0;
+  page_tuples_.clear();
+  page_tuple_index_ = 0;
+  page_copies_used_ = 0;
+
+  // Comparisons of columns with constants are evaluated on the raw tuples, the rest of the predicate on the batch.
+  kernel_filters_.clear();
+  residual_predicate_ = nullptr;
+  if (plan_->filter_predicate_ != nullptr) {
+    residual_predicate_ = ColumnConstantFilter::Split(plan_->filter_predicate_, table_info_->schema_, &kernel_filters_);
+  }
+  compiled_predicate_ = residual_predicate_ == nullptr ? nullptr : CompiledExpression::Compile(*residual_predicate_);
+  cutoff_ = exec_ctx_->GetTopNCutoff(plan_);
+  cutoff_version_ = 0;
+  cutoff_filter_.reset();
+  bloom_filter_ = exec_ctx_->GetBloomFilter(plan_);
+}
+
+auto SeqScanExecutor::FindScanOfColumn(const AbstractPlanNode *plan, uint32_t *column) -> const SeqScanPlanNode * {
+  while (plan->GetType() != PlanType::SeqScan) {
+    if (plan->GetType() == PlanType::Projection) {
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode *>(plan)->GetExpressions();
+      const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(exprs[*column].get());
+      if (column_expr == nullptr) {
+        return nullptr;
+      }
+      *column = column_expr->GetColIdx();
+    } else if (plan->GetType() != PlanType::Filter) {
+      return nullptr;
+    }
+    plan = plan->GetChildAt(0).get();
+  }
+  return dynamic_cast<const SeqScanPlanNode *>(plan);
+}
+
+auto SeqScanExecutor::NextTuple(Tuple *tuple) -> bool {
+  while (page_tuple_index_ == page_tuples_.size()) {
+    if (morsel_page_ == morsel_end_ && !morsels_->Next(&morsel_page_, &morsel_end_)) {
+      return false;
+    }
+    page_tuples_.clear();
+    page_tuple_index_ = 0;
+    if (page_copies_used_ == page_copies_.size()) {
+      page_copies_.push_back(std::make_unique<char[]>(BUSTUB_PAGE_SIZE));
+    }
+    table_info_->table_->GetPageTupleViews(morsels_->GetPageId(morsel_page_++),
+                                           page_copies_[page_copies_used_++].get(), &page_tuples_);
+  }
+  *tuple = page_tuples_[page_tuple_index_++];
+  return true;
+}
+
+void SeqScanExecutor::RecyclePageCopies() {
+  if (page_copies_used_ > 1) {
+    // The rest of the current page still points into its copy, which moves to the front.
+    std::swap(page_copies_[0], page_copies_[page_copies_used_ - 1]);
+    page_copies_used_ = 1;
+  }
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  RecyclePageCopies();
+  while (NextTuple(tuple)) {
+    *rid = tuple->GetRid();
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(tuple, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    // The caller may keep the tuple past the next call.
+    tuple->Materialize();
+    return true;
+  }
+  return false;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  std::vector<Value> values{};
+  while (true) {
+    // The tuples of the previous batch have been materialized into it.
+    RecyclePageCopies();
+    size_t rows = 0;
+    while (rows < TUPLE_BATCH_SIZE) {
+      if (rows == tuples_.size()) {
+        tuples_.emplace_back();
+      }
+      if (!NextTuple(&tuples_[rows])) {
+        break;
+      }
+      rows++;
+    }
+    if (rows == 0) {
+      batch->Reset(&GetOutputSchema());
+      return false;
+    }
+
+    if (cutoff_ != nullptr && cutoff_->GetVersion() != cutoff_version_) {
+      cutoff_version_ = cutoff_->GetVersion();
+      cutoff_filter_ = cutoff_->MakeFilter(table_info_->schema_);
+    }
+
+    // Only the tuples that pass the kernels are materialized into the batch.
+    batch->Reset(&GetOutputSchema());
+    const bool apply_bloom_filter = bloom_filter_ != nullptr && bloom_filter_->IsActive();
+    if (kernel_filters_.empty() && !cutoff_filter_.has_value() && !apply_bloom_filter) {
+      for (size_t i = 0; i < rows; i++) {
+        batch->AppendTuple(tuples_[i]);
+      }
+    } else {
+      bitmap_.assign(BitmapWords(rows), ~uint64_t{0});
+      for (auto &filter : kernel_filters_) {
+        filter.Apply(tuples_, rows, bitmap_.data());
+      }
+      if (cutoff_filter_.has_value()) {
+        cutoff_filter_->Apply(tuples_, rows, bitmap_.data());
+      }
+      if (apply_bloom_filter) {
+        bloom_filter_->Apply(table_info_->schema_, tuples_, rows, bitmap_.data());
+      }
+      for (size_t w = 0; w < bitmap_.size(); w++) {
+        for (uint64_t word = bitmap_[w]; word != 0; word &= word - 1) {
+          batch->AppendTuple(tuples_[w * 64 + __builtin_ctzll(word)]);
+        }
+      }
+      if (batch->Size() == 0) {
+        continue;
+      }
+    }
+    if (residual_predicate_ == nullptr) {
+      return true;
+    }
+
+    std::vector<uint32_t> selection{};
+    if (compiled_predicate_ != nullptr) {
+      compiled_predicate_->Select(*batch, &selection);
+    } else {
+      residual_predicate_->EvaluateBatch(*batch, &values);
+      for (size_t i = 0; i < values.size(); i++) {
+        if (!values[i].IsNull() && values[i].GetAs<bool>()) {
+          selection.push_back(i);
+        }
+      }
+    }
+    if (!selection.empty()) {
+      batch->SetSelection(std::move(selection));
+      return true;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -1,13 +1,293 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+
 namespace bustub {
 
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      child_executor_{std::move(child_executor)},
+      gather_{dynamic_cast<GatherExecutor *>(child_executor_.get())},
+      encoder_{plan->GetOrderBy()} {}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  chunks_.clear();
+  sorted_.clear();
+  runs_.clear();
+  merge_.clear();
+
+  // Every run being merged pins a page, and so does the run the merge writes to.
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  fan_in_ = bpm == nullptr ? SORT_MERGE_FAN_IN : std::clamp<size_t>(bpm->GetPoolSize() / 2, 2, SORT_MERGE_FAN_IN);
+  const size_t num_chunks = gather_ != nullptr ? gather_->GetWorkerCount() : 1;
+  const size_t budget = exec_ctx_->GetSortMemoryBudget() / num_chunks;
+  for (size_t i = 0; i < num_chunks; i++) {
+    chunks_.emplace_back(plan_->GetOrderBy(), exec_ctx_->GetArenaBlockPool());
+  }
+
+  if (gather_ != nullptr) {
+    gather_->RunOnWorkers([&](size_t worker, TupleBatch *batch) { AddBatch(&chunks_[worker], *batch, budget); });
+  } else {
+    TupleBatch batch;
+    while (child_executor_->NextBatch(&batch)) {
+      AddBatch(&chunks_[0], batch, budget);
+    }
+  }
+
+  SortInMemory();
+  MergeRuns();
+  merge_.reserve(runs_.size() + 1);
+  for (auto &run : runs_) {
+    merge_.emplace_back().run_ = std::move(run);
+  }
+  runs_.clear();
+  if (!sorted_.empty()) {
+    merge_.emplace_back();
+  }
+  StartMerge(&merge_, &tree_);
+}
+
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (merge_.empty()) {
+    return false;
+  }
+  const auto &head = merge_[tree_.Winner()];
+  if (head.tuple_ == nullptr) {
+    return false;
+  }
+  // The tuples in memory live in the arenas of the chunks, which the next Init resets.
+  *tuple = *head.tuple_;
+  tuple->Materialize();
+  *rid = tuple->GetRid();
+  AdvanceMerge(&merge_, &tree_);
+  return true;
+}
+
+void SortExecutor::AddBatch(SortChunk *chunk, const TupleBatch &batch, size_t budget) {
+  chunk->encoder_.EncodeBatch(batch, &chunk->keys_);
+  for (size_t i = 0; i < chunk->keys_.size(); i++) {
+    const auto &entry = chunk->entries_.emplace_back(std::move(chunk->keys_[i]), batch, i, &chunk->arena_);
+    chunk->memory_usage_ += sizeof(SortEntry) + sizeof(const SortEntry *) + entry.key_.size();
+    chunk->memory_usage_ += entry.tuple_.GetLength();
+    if (chunk->memory_usage_ > budget && exec_ctx_->GetBufferPoolManager() != nullptr) {
+      WriteRun(chunk);
+    }
+  }
+}
+
+void SortExecutor::WriteRun(SortChunk *chunk) {
+  auto run = std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager());
+  for (const auto *entry : SortChunkEntries(*chunk)) {
+    run->Append(entry->tuple_);
+  }
+  run->FinishAppend();
+  chunk->entries_.clear();
+  chunk->arena_.Reset();
+  chunk->memory_usage_ = 0;
+  std::scoped_lock lock(runs_latch_);
+  runs_.push_back(std::move(run));
+}
+
+auto SortExecutor::SortChunkEntries(const SortChunk &chunk) -> SortedEntries {
+  SortedEntries sorted;
+  sorted.reserve(chunk.entries_.size());
+  for (const auto &entry : chunk.entries_) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const SortEntry *a, const SortEntry *b) { return SortKeyLess(a->key_, b->key_); });
+  return sorted;
+}
+
+void SortExecutor::SortInMemory() {
+  auto *worker_pool = exec_ctx_->GetWorkerPool();
+  const size_t num_workers = worker_pool == nullptr ? 1 : exec_ctx_->GetWorkerCount();
+  size_t total = 0;
+  for (const auto &chunk : chunks_) {
+    total += chunk.entries_.size();
+  }
+
+  // Cut the chunks into slices of about total / num_workers tuples, so that every worker has one to sort.
+  const size_t slice_rows =
+      num_workers == 1 ? total : std::max(SORT_SLICE_ROWS, (total + num_workers - 1) / num_workers);
+  std::vector<SortedEntries> slices;
+  for (const auto &chunk : chunks_) {
+    for (auto it = chunk.entries_.begin(); it != chunk.entries_.end();) {
+      auto &slice = slices.emplace_back();
+      slice.reserve(std::min(slice_rows, chunk.entries_.size()));
+      for (; it != chunk.entries_.end() && slice.size() < slice_rows; ++it) {
+        slice.push_back(&*it);
+      }
+    }
+  }
+  auto sort_slice = [&](size_t i) {
+    std::sort(slices[i].begin(), slices[i].end(),
+              [](const SortEntry *a, const SortEntry *b) { return SortKeyLess(a->key_, b->key_); });
+  };
+  if (slices.size() == 1) {
+    sort_slice(0);
+    sorted_ = std::move(slices[0]);
+  } else if (!slices.empty()) {
+    worker_pool->ParallelFor(slices.size(), sort_slice);
+    MergeInMemory(slices);
+  }
+}
+
+void SortExecutor::MergeInMemory(const std::vector<SortedEntries> &slices) {
+  size_t total = 0;
+  for (const auto &slice : slices) {
+    total += slice.size();
+  }
+  sorted_.assign(total, nullptr);
+  auto *worker_pool = exec_ctx_->GetWorkerPool();
+  const size_t parts = worker_pool == nullptr ? 1 : std::min(exec_ctx_->GetWorkerCount(), total / SORT_SLICE_ROWS + 1);
+
+  // Splitters are taken at even distances from a regular sample of every slice, so that each part gets about
+  // total / parts tuples unless keys repeat a lot.
+  std::vector<const std::string *> samples;
+  const size_t samples_per_part = 16;
+  for (const auto &slice : slices) {
+    const size_t step = std::max<size_t>(1, slice.size() / (parts * samples_per_part));
+    for (size_t i = step / 2; i < slice.size(); i += step) {
+      samples.push_back(&slice[i]->key_);
+    }
+  }
+  std::sort(samples.begin(), samples.end(),
+            [](const std::string *a, const std::string *b) { return SortKeyLess(*a, *b); });
+
+  // bounds[p][s] is the first position in slice s of part p, that is, of a tuple not before the splitter of part p.
+  std::vector<std::vector<size_t>> bounds(parts + 1, std::vector<size_t>(slices.size(), 0));
+  std::vector<size_t> offsets(parts + 1, 0);
+  for (size_t p = 1; p <= parts; p++) {
+    for (size_t s = 0; s < slices.size(); s++) {
+      if (p == parts) {
+        bounds[p][s] = slices[s].size();
+      } else {
+        const auto &splitter = *samples[p * samples.size() / parts];
+        bounds[p][s] = std::lower_bound(slices[s].begin(), slices[s].end(), splitter,
+                                        [](const SortEntry *entry, const std::string &key) {
+                                          return SortKeyLess(entry->key_, key);
+                                        }) -
+                       slices[s].begin();
+      }
+      offsets[p] += bounds[p][s];
+    }
+  }
+
+  auto merge_part = [&](size_t p) {
+    std::vector<size_t> positions(bounds[p]);
+    const auto &ends = bounds[p + 1];
+    auto less = [&](size_t a, size_t b) {
+      if (positions[a] == ends[a]) {
+        return false;
+      }
+      return positions[b] == ends[b] || SortKeyLess(slices[a][positions[a]]->key_, slices[b][positions[b]]->key_);
+    };
+    LoserTree tree;
+    tree.Init(slices.size(), less);
+    for (size_t out = offsets[p]; out < offsets[p + 1]; out++) {
+      const size_t winner = tree.Winner();
+      sorted_[out] = slices[winner][positions[winner]++];
+      tree.Replay(less);
+    }
+  };
+  if (parts == 1) {
+    merge_part(0);
+  } else {
+    worker_pool->ParallelFor(parts, merge_part);
+  }
+}
+
+void SortExecutor::MergeRuns() {
+  // Every merge of a group pins fan_in_ + 1 pages, so only as many groups are merged at once as the pool holds.
+  auto *worker_pool = exec_ctx_->GetWorkerPool();
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  size_t parallel = 1;
+  if (worker_pool != nullptr && bpm != nullptr) {
+    parallel = std::clamp<size_t>(bpm->GetPoolSize() / (2 * (fan_in_ + 1)), 1, exec_ctx_->GetWorkerCount());
+  }
+
+  while (runs_.size() + (sorted_.empty() ? 0 : 1) > fan_in_) {
+    // Merge just enough groups to get down to fan_in_ inputs, at most `parallel` of them at a time.
+    const size_t excess = runs_.size() + (sorted_.empty() ? 0 : 1) - fan_in_;
+    const size_t groups = std::min(parallel, (excess + fan_in_ - 2) / (fan_in_ - 1));
+    std::vector<std::vector<std::unique_ptr<TmpTuplePartition>>> inputs(groups);
+    for (auto &group : inputs) {
+      while (group.size() < fan_in_ && !runs_.empty()) {
+        group.push_back(std::move(runs_.front()));
+        runs_.pop_front();
+      }
+    }
+    std::vector<std::unique_ptr<TmpTuplePartition>> merged(groups);
+    if (groups == 1) {
+      merged[0] = MergeRunGroup(std::move(inputs[0]));
+    } else {
+      worker_pool->ParallelFor(groups, [&](size_t i) { merged[i] = MergeRunGroup(std::move(inputs[i])); });
+    }
+    for (auto &run : merged) {
+      runs_.push_back(std::move(run));
+    }
+  }
+}
+
+auto SortExecutor::MergeRunGroup(std::vector<std::unique_ptr<TmpTuplePartition>> runs)
+    -> std::unique_ptr<TmpTuplePartition> {
+  std::vector<RunCursor> cursors(runs.size());
+  for (size_t i = 0; i < runs.size(); i++) {
+    cursors[i].run_ = std::move(runs[i]);
+  }
+  LoserTree tree;
+  StartMerge(&cursors, &tree);
+  auto merged = std::make_unique<TmpTuplePartition>(exec_ctx_->GetBufferPoolManager());
+  for (const RunCursor *head = &cursors[tree.Winner()]; head->tuple_ != nullptr; head = &cursors[tree.Winner()]) {
+    merged->Append(*head->tuple_);
+    AdvanceMerge(&cursors, &tree);
+  }
+  merged->FinishAppend();
+  return merged;
+}
+
+void SortExecutor::Advance(RunCursor *cursor) {
+  if (cursor->run_ == nullptr) {
+    if (cursor->position_ < sorted_.size()) {
+      const auto *entry = sorted_[cursor->position_++];
+      cursor->key_ = &entry->key_;
+      cursor->tuple_ = &entry->tuple_;
+      return;
+    }
+  } else if (cursor->run_->Next(&cursor->tuple_buffer_)) {
+    // Runs only hold the tuples, so the keys are encoded again as they are read back.
+    encoder_.EncodeTuple(cursor->tuple_buffer_, child_executor_->GetOutputSchema(), &cursor->key_buffer_);
+    cursor->key_ = &cursor->key_buffer_;
+    cursor->tuple_ = &cursor->tuple_buffer_;
+    return;
+  }
+  cursor->key_ = nullptr;
+  cursor->tuple_ = nullptr;
+}
+
+auto SortExecutor::HeadBefore(const std::vector<RunCursor> &cursors, size_t a, size_t b) -> bool {
+  const auto *key_a = cursors[a].key_;
+  const auto *key_b = cursors[b].key_;
+  return key_a != nullptr && (key_b == nullptr || SortKeyLess(*key_a, *key_b));
+}
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+void SortExecutor::StartMerge(std::vector<RunCursor> *cursors, LoserTree *tree) {
+  if (cursors->empty()) {
+    return;
+  }
+  for (auto &cursor : *cursors) {
+    Advance(&cursor);
+  }
+  tree->Init(cursors->size(), [cursors](size_t a, size_t b) { return HeadBefore(*cursors, a, b); });
+}
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+void SortExecutor::AdvanceMerge(std::vector<RunCursor> *cursors, LoserTree *tree) {
+  Advance(&(*cursors)[tree->Winner()]);
+  tree->Replay([cursors](size_t a, size_t b) { return HeadBefore(*cursors, a, b); });
+}
 
 }  // namespace bustub
@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.cpp
+//
+// Identification: src/execution/sort_key.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key.h"
+
+#include <cstdint>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Appends the lowest bytes of an unsigned integer, most significant first */
+void AppendBigEndian(uint64_t bits, size_t bytes, std::string *key) {
+  for (size_t i = bytes; i-- > 0;) {
+    key->push_back(static_cast<char>(bits >> (i * 8)));
+  }
+}
+
+/** Appends a signed integer of the given width, with the sign bit flipped so that negative numbers come first */
+void AppendSigned(int64_t value, size_t bytes, std::string *key) {
+  const auto sign = uint64_t{1} << (bytes * 8 - 1);
+  AppendBigEndian(static_cast<uint64_t>(value) ^ sign, bytes, key);
+}
+
+}  // namespace
+
+void SortKeyEncoder::EncodeValue(const Value &value, bool descending, std::string *key) {
+  const size_t start = key->size();
+  if (value.IsNull()) {
+    key->push_back(0);
+  } else {
+    key->push_back(1);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        key->push_back(value.GetAs<int8_t>());
+        break;
+      case TypeId::TINYINT:
+        AppendSigned(value.GetAs<int8_t>(), sizeof(int8_t), key);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned(value.GetAs<int16_t>(), sizeof(int16_t), key);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned(value.GetAs<int32_t>(), sizeof(int32_t), key);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned(value.GetAs<int64_t>(), sizeof(int64_t), key);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), sizeof(uint64_t), key);
+        break;
+      case TypeId::DECIMAL: {
+        const auto decimal = value.GetAs<double>();
+        uint64_t bits;
+        std::memcpy(&bits, &decimal, sizeof(bits));
+        // Negative numbers grow with their magnitude, so all of their bits are inverted.
+        bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+        AppendBigEndian(bits, sizeof(bits), key);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        const char *data = value.GetData();
+        const uint32_t length = value.GetLength() - 1;
+        for (uint32_t i = 0; i < length; i++) {
+          key->push_back(data[i]);
+          if (data[i] == 0) {
+            key->push_back(static_cast<char>(0xFF));
+          }
+        }
+        key->append(2, 0);
+        break;
+      }
+      default:
+        throw Exception(ExceptionType::MISMATCH_TYPE, "cannot sort on a value of this type");
+    }
+  }
+  if (descending) {
+    for (size_t i = start; i < key->size(); i++) {
+      (*key)[i] = static_cast<char>(~(*key)[i]);
+    }
+  }
+}
+
+void SortKeyEncoder::EncodeTuple(const Tuple &tuple, const Schema &schema, std::string *key) const {
+  key->clear();
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    EncodeValue(expr->Evaluate(&tuple, schema), order_by_type == OrderByType::DESC, key);
+  }
+}
+
+void SortKeyEncoder::EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys) {
+  keys->resize(batch.Size());
+  for (auto &key : *keys) {
+    key.clear();
+  }
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    expr->EvaluateBatch(batch, &values_);
+    for (size_t i = 0; i < values_.size(); i++) {
+      EncodeValue(values_[i], order_by_type == OrderByType::DESC, &(*keys)[i]);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -1,13 +1,111 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+
 namespace bustub {
 
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      child_executor_{std::move(child_executor)},
+      gather_{dynamic_cast<GatherExecutor *>(child_executor_.get())} {}
+
+void TopNExecutor::Init() {
+  heaps_.clear();
+  result_.clear();
+  position_ = 0;
+  if (plan_->GetN() == 0) {
+    return;
+  }
+
+  // The scan picks up the cutoff while it is initialized; it is only registered for that long.
+  uint32_t column = 0;
+  const auto *scan = FindCutoffScan(&column);
+  cutoff_ = nullptr;
+  if (scan != nullptr) {
+    const auto &order_bys = plan_->GetOrderBy();
+    cutoff_ = std::make_shared<TopNCutoff>(column, order_bys[0].first == OrderByType::DESC, order_bys.size() == 1);
+    exec_ctx_->SetTopNCutoff(scan, cutoff_);
+  }
+  child_executor_->Init();
+  if (scan != nullptr) {
+    exec_ctx_->SetTopNCutoff(scan, nullptr);
+  }
+
+  const size_t num_heaps = gather_ != nullptr ? gather_->GetWorkerCount() : 1;
+  heaps_.reserve(num_heaps);
+  for (size_t i = 0; i < num_heaps; i++) {
+    heaps_.emplace_back(plan_->GetOrderBy());
+  }
+  if (gather_ != nullptr) {
+    gather_->RunOnWorkers([&](size_t worker, TupleBatch *batch) { AddBatch(&heaps_[worker], *batch); });
+  } else {
+    TupleBatch batch;
+    while (child_executor_->NextBatch(&batch)) {
+      AddBatch(&heaps_[0], batch);
+    }
+  }
+
+  for (const auto &heap : heaps_) {
+    for (const auto &entry : heap.entries_) {
+      result_.push_back(&entry);
+    }
+  }
+  const size_t n = std::min(plan_->GetN(), result_.size());
+  std::partial_sort(result_.begin(), result_.begin() + n, result_.end(),
+                    [](const TopNEntry *a, const TopNEntry *b) { return SortKeyLess(a->key_, b->key_); });
+  result_.resize(n);
+}
+
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (position_ == result_.size()) {
+    return false;
+  }
+  *tuple = result_[position_++]->tuple_;
+  *rid = tuple->GetRid();
+  return true;
+}
+
+void TopNExecutor::AddBatch(TopNHeap *heap, const TupleBatch &batch) {
+  const size_t n = plan_->GetN();
+  auto &entries = heap->entries_;
+  auto before = [&entries](size_t a, size_t b) { return SortKeyLess(entries[a].key_, entries[b].key_); };
+  heap->encoder_.EncodeBatch(batch, &heap->keys_);
+  bool changed = false;
+  for (size_t i = 0; i < heap->keys_.size(); i++) {
+    if (heap->heap_.size() < n) {
+      entries.emplace_back(std::move(heap->keys_[i]), batch, i);
+      heap->heap_.push_back(entries.size() - 1);
+      std::push_heap(heap->heap_.begin(), heap->heap_.end(), before);
+      changed = true;
+    } else if (SortKeyLess(heap->keys_[i], entries[heap->heap_.front()].key_)) {
+      // Only the key is compared with the worst tuple, the tuple is built if the row gets in.
+      std::pop_heap(heap->heap_.begin(), heap->heap_.end(), before);
+      auto &entry = entries[heap->heap_.back()];
+      entry.key_ = std::move(heap->keys_[i]);
+      entry.tuple_ = batch.GetTuple(i);
+      std::push_heap(heap->heap_.begin(), heap->heap_.end(), before);
+      changed = true;
+    }
+  }
 
-void TopNExecutor::Init() { throw NotImplementedException("TopNExecutor is not implemented"); }
+  if (changed && cutoff_ != nullptr && heap->heap_.size() == n) {
+    const auto &worst = entries[heap->heap_.front()].tuple_;
+    cutoff_->Update(plan_->GetOrderBy()[0].second->Evaluate(&worst, child_executor_->GetOutputSchema()));
+  }
+}
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto TopNExecutor::FindCutoffScan(uint32_t *column) const -> const AbstractPlanNode * {
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(plan_->GetOrderBy()[0].second.get());
+  if (column_expr == nullptr || column_expr->GetTupleIdx() != 0) {
+    return nullptr;
+  }
+  *column = column_expr->GetColIdx();
+  return SeqScanExecutor::FindScanOfColumn(plan_->GetChildPlan().get(), column);
+}
 
 }  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.cpp
+//
+// Identification: src/execution/worker_pool.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/worker_pool.h"
+
+namespace bustub {
+
+WorkerPool::WorkerPool(size_t num_threads) { Reserve(num_threads); }
+
+WorkerPool::~WorkerPool() {
+  {
+    std::scoped_lock lock(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Reserve(size_t num_threads) {
+  std::scoped_lock lock(latch_);
+  while (threads_.size() < num_threads) {
+    threads_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+auto WorkerPool::Submit(std::function<void()> task) -> std::future<void> {
+  std::packaged_task<void()> packaged{std::move(task)};
+  auto future = packaged.get_future();
+  {
+    std::scoped_lock lock(latch_);
+    tasks_.push_back(std::move(packaged));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)> &task) {
+  std::vector<std::future<void>> futures;
+  futures.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    futures.push_back(Submit([&task, i] { task(i); }));
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+}
+
+void WorkerPool::WorkerLoop() {
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock lock(latch_);
+      cv_.wait(lock, [this] { return shutdown_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    // Exceptions are stored in the future of the task.
+    task();
+  }
+}
+
+}  // namespace bustub
@@ -18,6 +18,7 @@ enum ExplainOptions : uint8_t {
   PLANNER = 2,   /**< Show planner results. */
   OPTIMIZER = 4, /**< Show optimizer results. */
   SCHEMA = 8,    /**< Show schema. */
+  ANALYZE = 16,  /**< Run the query and show what its executors did. */
 };
 
 namespace bustub {
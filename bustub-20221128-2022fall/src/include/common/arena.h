@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/common/arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ArenaBlockPool holds the blocks of ARENA_BLOCK_SIZE bytes that the arenas of a query allocate from. An arena that is
+ * reset gives its blocks back to the pool, where the next arena, or the same one, picks them up again instead of
+ * allocating new ones. The pool is shared by all workers of the query.
+ */
+class ArenaBlockPool {
+ public:
+  ArenaBlockPool() = default;
+
+  DISALLOW_COPY_AND_MOVE(ArenaBlockPool);
+
+  /** @return A block of ARENA_BLOCK_SIZE bytes, reused if the pool has one */
+  auto Take() -> std::unique_ptr<char[]> {
+    std::scoped_lock lock(latch_);
+    if (free_blocks_.empty()) {
+      allocated_blocks_++;
+      return std::unique_ptr<char[]>(new char[ARENA_BLOCK_SIZE]);
+    }
+    auto block = std::move(free_blocks_.back());
+    free_blocks_.pop_back();
+    return block;
+  }
+
+  /** Gives blocks back to the pool */
+  void Return(std::vector<std::unique_ptr<char[]>> *blocks) {
+    std::scoped_lock lock(latch_);
+    for (auto &block : *blocks) {
+      free_blocks_.push_back(std::move(block));
+    }
+    blocks->clear();
+  }
+
+  /** @return The number of blocks the pool allocated */
+  auto GetAllocatedBlocks() -> size_t {
+    std::scoped_lock lock(latch_);
+    return allocated_blocks_;
+  }
+
+ private:
+  std::mutex latch_;
+  std::vector<std::unique_ptr<char[]>> free_blocks_{};
+  size_t allocated_blocks_{0};
+};
+
+/**
+ * Arena hands out memory by bumping a pointer through blocks, and frees all of it at once when it is reset or
+ * destroyed, which suits data that an executor holds for a phase of the query and drops together, such as the build
+ * tuples of a hash join. The memory is 8-byte aligned and not initialized. Allocations larger than a quarter of a block
+ * get memory of their own. An arena is used by one thread at a time.
+ */
+class Arena {
+ public:
+  /** @param pool where the arena takes its blocks from, or `nullptr` to allocate them itself */
+  explicit Arena(ArenaBlockPool *pool = nullptr) : pool_{pool} {}
+
+  Arena(Arena &&other) noexcept
+      : pool_{other.pool_},
+        blocks_{std::move(other.blocks_)},
+        large_{std::move(other.large_)},
+        ptr_{std::exchange(other.ptr_, nullptr)},
+        end_{std::exchange(other.end_, nullptr)} {}
+
+  auto operator=(Arena &&other) noexcept -> Arena & {
+    if (this != &other) {
+      Reset();
+      pool_ = other.pool_;
+      blocks_ = std::move(other.blocks_);
+      large_ = std::move(other.large_);
+      ptr_ = std::exchange(other.ptr_, nullptr);
+      end_ = std::exchange(other.end_, nullptr);
+    }
+    return *this;
+  }
+
+  DISALLOW_COPY(Arena);
+
+  ~Arena() { Reset(); }
+
+  /** @return `size` bytes, valid until the arena is reset */
+  auto Allocate(size_t size) -> char * {
+    size = (size + 7) & ~size_t{7};
+    if (size > static_cast<size_t>(end_ - ptr_)) {
+      return AllocateSlow(size);
+    }
+    auto *result = ptr_;
+    ptr_ += size;
+    return result;
+  }
+
+  /** Frees everything allocated from the arena, giving its blocks back to the pool */
+  void Reset() {
+    if (pool_ != nullptr) {
+      pool_->Return(&blocks_);
+    }
+    blocks_.clear();
+    large_.clear();
+    ptr_ = nullptr;
+    end_ = nullptr;
+  }
+
+  /** @return The bytes of memory the arena holds */
+  auto GetMemoryUsage() const -> size_t {
+    size_t usage = blocks_.size() * ARENA_BLOCK_SIZE;
+    for (const auto &[_, size] : large_) {
+      usage += size;
+    }
+    return usage;
+  }
+
+ private:
+  auto AllocateSlow(size_t size) -> char * {
+    if (size > ARENA_BLOCK_SIZE / 4) {
+      return large_.emplace_back(std::unique_ptr<char[]>(new char[size]), size).first.get();
+    }
+    blocks_.push_back(pool_ != nullptr ? pool_->Take() : std::unique_ptr<char[]>(new char[ARENA_BLOCK_SIZE]));
+    ptr_ = blocks_.back().get() + size;
+    end_ = blocks_.back().get() + ARENA_BLOCK_SIZE;
+    return blocks_.back().get();
+  }
+
+  ArenaBlockPool *pool_;
+  std::vector<std::unique_ptr<char[]>> blocks_{};
+  /** The allocations that got memory of their own, with their size */
+  std::vector<std::pair<std::unique_ptr<char[]>, size_t>> large_{};
+  /** The free part of the last block */
+  char *ptr_{nullptr};
+  char *end_{nullptr};
+};
+
+}  // namespace bustub
@@ -12,12 +12,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -266,6 +268,52 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return The number of threads a query may use, the number of cores unless set by `execution_threads` */
+  auto GetExecutionThreads() -> size_t {
+    auto variable = GetSessionVariable("execution_threads");
+    if (!variable.empty() && variable.size() <= 3 && std::all_of(variable.begin(), variable.end(), ::isdigit) &&
+        std::stoul(variable) > 0) {
+      return std::stoul(variable);
+    }
+    return std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  /** @return the number of bytes of tuples a sort keeps in memory, as set by `sort_memory_budget` */
+  auto GetSortMemoryBudget() -> size_t {
+    auto variable = GetSessionVariable("sort_memory_budget");
+    if (!variable.empty() && variable.size() <= 12 && std::all_of(variable.begin(), variable.end(), ::isdigit) &&
+        std::stoull(variable) > 0) {
+      return std::stoull(variable);
+    }
+    return SORT_MEMORY_BUDGET;
+  }
+
+  /** @return the number of pages of outer tuples a nested loop join buffers, as set by `nlj_block_pages` */
+  auto GetNLJBlockPages() -> size_t {
+    auto variable = GetSessionVariable("nlj_block_pages");
+    if (!variable.empty() && variable.size() <= 6 && std::all_of(variable.begin(), variable.end(), ::isdigit) &&
+        std::stoul(variable) > 0) {
+      return std::stoul(variable);
+    }
+    return NLJ_BLOCK_PAGES;
+  }
+
+  /** @return the estimated build tuples from which hash joins are radix-partitioned, as set by `radix_join_build_rows` */
+  auto GetRadixJoinBuildRows() -> size_t {
+    auto variable = GetSessionVariable("radix_join_build_rows");
+    if (!variable.empty() && variable.size() <= 12 && std::all_of(variable.begin(), variable.end(), ::isdigit) &&
+        std::stoull(variable) > 0) {
+      return std::stoull(variable);
+    }
+    return RADIX_JOIN_BUILD_ROWS;
+  }
+
+  /** @return Whether queries run as push-based pipelines, unless `push_execution` is turned off */
+  auto IsPushExecution() -> bool {
+    auto variable = StringUtil::Lower(GetSessionVariable("push_execution"));
+    return !(variable == "0" || variable == "false" || variable == "no");
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
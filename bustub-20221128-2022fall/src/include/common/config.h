@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -36,6 +37,23 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int LINEAR_PROBE_MIGRATE_BLOCKS = 1;  // blocks moved per operation while a linear probe table grows
+static constexpr double LINEAR_PROBE_MAX_LOAD = 0.75;  // occupied fraction that makes a linear probe table grow
+static constexpr size_t AGGREGATION_MEMORY_BUDGET = 4 << 20;  // bytes of groups a hash aggregation keeps in memory
+static constexpr size_t AGGREGATION_SPILL_PARTITIONS = 8;     // partitions a hash aggregation spills to, power of 2
+static constexpr size_t HASH_JOIN_MEMORY_BUDGET = 4 << 20;     // bytes of build tuples a hash join keeps in memory
+static constexpr size_t HASH_JOIN_PARTITIONS = 8;              // partitions a hash join splits its inputs in, power of 2
+static constexpr size_t RADIX_JOIN_BUILD_ROWS = 100000;        // estimated build tuples that call for a radix join
+static constexpr size_t RADIX_JOIN_PARTITION_BYTES = 1 << 18;  // bytes of build tuples in a radix join partition
+static constexpr size_t RADIX_JOIN_PROBE_ROWS = 65536;         // probe tuples a radix join partitions at a time
+static constexpr size_t SORT_MEMORY_BUDGET = 4 << 20;          // default bytes of input a sort holds in memory
+static constexpr size_t SORT_MERGE_FAN_IN = 16;                // sorted runs an external sort merges at a time
+static constexpr size_t SORT_SLICE_ROWS = 16384;              // fewest tuples a sort hands to a worker to sort
+static constexpr size_t NLJ_BLOCK_PAGES = 16;                 // default pages of left tuples a nested loop join holds
+static constexpr size_t BLOOM_FILTER_BITS_PER_KEY = 8;        // fewest bits a Bloom filter has per build key
+static constexpr uint32_t BLOOM_FILTER_HASHES = 3;            // bits a Bloom filter sets for each key
+static constexpr size_t BLOOM_FILTER_SAMPLE_ROWS = 16384;     // rows a scan applies a Bloom filter to before judging it
+static constexpr double BLOOM_FILTER_MAX_PASS_RATE = 0.9;     // pass rate above which a scan drops a Bloom filter
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -44,6 +62,10 @@ using lsn_t = int32_t;         // log sequence number type
 using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
 
-static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
+static constexpr int VARCHAR_DEFAULT_LENGTH = 128;    // default length for varchar when constructing the column
+static constexpr size_t TUPLE_BATCH_SIZE = 1024;      // number of rows executors pass to each other in NextBatch
+static constexpr size_t MORSEL_PAGES = 16;            // table pages a parallel scan hands to a worker at a time
+static constexpr size_t MORSEL_ROWS = 16384;          // mock table rows a parallel scan hands to a worker at a time
+static constexpr size_t ARENA_BLOCK_SIZE = 64 << 10;  // bytes of the blocks an arena hands out memory from
 
 }  // namespace bustub
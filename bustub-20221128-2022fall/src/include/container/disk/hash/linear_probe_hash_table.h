@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -30,6 +31,15 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Growing is incremental: Resize() only allocates the new layout, and every
+ * subsequent Insert() / Remove() migrates LINEAR_PROBE_MIGRATE_BLOCKS blocks
+ * of the old layout into it. While a migration is in progress new entries go
+ * to the new layout, and lookups probe the old layout first and then the new
+ * one. Entries are always copied into the new layout before they are removed
+ * from the old one, so a lookup in that order never misses an entry that is
+ * being moved. The table latch is only taken exclusively to start and to
+ * finish a migration.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,33 +83,56 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Starts resizing the table to at least twice the initial size provided.
+   * The entries are moved over incrementally by later inserts and removes.
+   * Does nothing if a resize is already in progress or the table has already
+   * grown past twice the initial size.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
+  /**
+   * @return true if entries are still being migrated to a new layout
+   */
+  auto IsResizing() -> bool;
+
   /**
    * Gets the size of the hash table
-   * @return current size of the hash table
+   * @return current size of the hash table, i.e. the number of slots new entries are inserted into
    */
   auto GetSize() -> size_t;
 
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
-  auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
+  auto GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage *;
+  auto GetBlockPage(Page *page) -> HASH_TABLE_BLOCK_TYPE *;
+  auto ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value, bool *is_full)
+      -> bool;
+  auto RemoveFrom(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value) -> bool;
   void DeleteBlockPages(HashTableHeaderPage *old_header_page);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
-  auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  auto GetValueLatchFree(HashTableHeaderPage *header_page, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  void MigrateBlock(HashTableHeaderPage *old_header_page, HashTableHeaderPage *new_header_page, size_t block_index);
+  void MigrateStep(size_t max_blocks);
+  void FinishResize();
+  auto Hash(const KeyType &key) -> uint64_t;
 
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers includes inserts, removes and block migration, writer only starts or finishes a resize
   ReaderWriterLatch table_latch_;
 
+  // Header of the layout being migrated into, INVALID_PAGE_ID when no resize is in progress
+  page_id_t new_header_page_id_{INVALID_PAGE_ID};
+  // Next block of the old layout to hand out to a migrating operation
+  std::atomic<size_t> next_migrate_block_{0};
+  // Number of blocks of the old layout that have been completely migrated
+  std::atomic<size_t> migrated_blocks_{0};
+  // Occupied slots (tombstones included) in the layout new entries are inserted into
+  std::atomic<size_t> num_occupied_{0};
+
   // Hash function
   HashFunction<KeyType> hash_fn_;
 };
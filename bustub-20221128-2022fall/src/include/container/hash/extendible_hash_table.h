@@ -17,9 +17,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <shared_mutex>
 #include <utility>
 #include <vector>
 
@@ -29,6 +31,11 @@ namespace bustub {
 
 /**
  * ExtendibleHashTable implements a hash table using the extendible hashing algorithm.
+ *
+ * Every bucket has its own reader/writer latch. Find / Insert / Remove hold the directory latch in shared mode and
+ * latch only the bucket the key hashes to, so operations on different buckets run in parallel. Splitting a bucket
+ * happens under its write latch; the directory latch is taken exclusively only to double the directory.
+ *
  * @tparam K key type
  * @tparam V value type
  */
@@ -157,30 +164,46 @@ class ExtendibleHashTable : public HashTable<K, V> {
      */
     auto Insert(const K &key, const V &value) -> bool;
 
+    /** @brief The latch protecting the items and the local depth of this bucket. */
+    inline auto GetLatch() const -> std::shared_mutex & { return latch_; }
+
    private:
     // TODO(student): You may add additional private members and helper functions
     size_t size_;
     int depth_;
     std::list<std::pair<K, V>> list_;
+    mutable std::shared_mutex latch_;
   };
 
  private:
   // TODO(student): You may add additional private members and helper functions and remove the ones
   // you don't need.
 
-  int global_depth_;    // The global depth of the directory
-  size_t bucket_size_;  // The size of a bucket
-  int num_buckets_;     // The number of buckets in the hash table
-  mutable std::mutex latch_;
-  std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
-
-  // The following functions are completely optional, you can delete them if you have your own ideas.
+  int global_depth_;              // The global depth of the directory
+  size_t bucket_size_;            // The size of a bucket
+  std::atomic<int> num_buckets_;  // The number of buckets in the hash table
+  // Shared by every operation, exclusive only while the directory doubles.
+  mutable std::shared_mutex latch_;
+  // The directory of the hash table. Slots are atomic so that a bucket split can repoint them under a shared latch_.
+  std::vector<std::atomic<Bucket *>> dir_;
+  std::vector<std::unique_ptr<Bucket>> buckets_;  // Owns every bucket the directory points to
+  std::mutex buckets_latch_;                      // Protects buckets_ when splits append to it concurrently
 
   /**
-   * @brief Redistribute the kv pairs in a full bucket.
+   * @brief Redistribute the kv pairs in a full bucket into itself and a new sibling bucket.
+   * Must hold latch_ in shared mode and the bucket's latch in exclusive mode.
    * @param bucket The bucket to be redistributed.
    */
-  auto RedistributeBucket(std::shared_ptr<Bucket> bucket) -> void;
+  auto RedistributeBucket(Bucket *bucket) -> void;
+
+  /**
+   * @brief Find the bucket the key hashes to and latch it. Retries if the bucket is split before the latch is
+   * acquired. Must hold latch_ in shared mode.
+   * @param key The key to be hashed.
+   * @param exclusive Whether to latch the bucket in exclusive mode.
+   * @return The latched bucket.
+   */
+  auto LatchBucket(const K &key, bool exclusive) -> Bucket *;
 
   /*****************************************************************
    * Must acquire latch_ first before calling the below functions. *
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/execution/bloom_filter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/util/hash_util.h"
+#include "execution/filter_kernels.h"
+#include "fmt/format.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter carries the join keys of the build side of a hash join over to the sequential scan on its probe side.
+ * The join inserts the hash of every build key, publishes the filter once its build phase is done, and from then on
+ * the scan drops the rows whose key is certainly not on the build side before they are materialized and probed. The
+ * scan stops applying a filter that turns out to let nearly every row through.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Creates an empty filter.
+   * @param column the index of the join key column in the schema of the scanned table
+   * @param column_name the name of the column, for EXPLAIN ANALYZE
+   */
+  BloomFilter(uint32_t column, std::string column_name) : column_{column}, column_name_{std::move(column_name)} {}
+
+  DISALLOW_COPY_AND_MOVE(BloomFilter);
+
+  /**
+   * Sizes the filter for the hashes of the build keys and sets their bits. Must be called before Publish.
+   * @param hashes the hashes of the build keys, as computed by HashKey
+   */
+  void Build(const std::vector<hash_t> &hashes) {
+    size_t bits = 64;
+    while (bits < hashes.size() * BLOOM_FILTER_BITS_PER_KEY) {
+      bits *= 2;
+    }
+    bits_.assign(bits / 64, 0);
+    mask_ = bits - 1;
+    for (auto hash : hashes) {
+      for (uint32_t i = 0; i < BLOOM_FILTER_HASHES; i++) {
+        const auto bit = Probe(hash, i);
+        bits_[bit / 64] |= uint64_t{1} << (bit % 64);
+      }
+    }
+    build_keys_ = hashes.size();
+  }
+
+  /** Makes the filter visible to the scan, which does not read it before */
+  void Publish() { published_.store(true, std::memory_order_release); }
+
+  /** @return Whether the scan should apply the filter: it is published and has not proven useless */
+  auto IsActive() const -> bool {
+    if (!published_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    // After a sample of rows, a filter that drops few of them is not worth its cost.
+    const auto probed = probed_.load(std::memory_order_relaxed);
+    return probed < BLOOM_FILTER_SAMPLE_ROWS ||
+           static_cast<double>(passed_.load(std::memory_order_relaxed)) < probed * BLOOM_FILTER_MAX_PASS_RATE;
+  }
+
+  /** @return The hash of a join key, the same for the build side and the scan */
+  static auto HashKey(const Value &key) -> hash_t { return HashUtil::MixHash(HashUtil::HashValue(&key)); }
+
+  /**
+   * Clears the bits of the tuples whose join key is null or certainly not on the build side.
+   * @param schema the schema of the scanned table
+   * @param tuples the tuples
+   * @param rows the number of tuples to evaluate, from the start of the vector
+   * @param[in,out] bitmap BitmapWords(rows) words, only the tuples with their bit set are evaluated; the bits past the
+   * last tuple are cleared
+   */
+  void Apply(const Schema &schema, const std::vector<Tuple> &tuples, size_t rows, uint64_t *bitmap) {
+    uint64_t probed = 0;
+    uint64_t passed = 0;
+    if (rows % 64 != 0) {
+      bitmap[rows / 64] &= (uint64_t{1} << (rows % 64)) - 1;
+    }
+    for (size_t w = 0; w < BitmapWords(rows); w++) {
+      for (uint64_t word = bitmap[w]; word != 0; word &= word - 1) {
+        const auto row = w * 64 + __builtin_ctzll(word);
+        const auto key = tuples[row].GetValue(&schema, column_);
+        probed++;
+        if (!key.IsNull() && MayContain(HashKey(key))) {
+          passed++;
+        } else {
+          bitmap[w] &= ~(uint64_t{1} << (row % 64));
+        }
+      }
+    }
+    probed_.fetch_add(probed, std::memory_order_relaxed);
+    passed_.fetch_add(passed, std::memory_order_relaxed);
+  }
+
+  /** @return A summary of the filter and of the rows it dropped, for EXPLAIN ANALYZE */
+  auto ToString() const -> std::string {
+    const auto probed = probed_.load(std::memory_order_relaxed);
+    const auto passed = passed_.load(std::memory_order_relaxed);
+    return fmt::format(
+        "BloomFilter {{ column={}, build_keys={}, bits={}, probed={}, passed={}, selectivity={:.3f} }}", column_name_,
+        build_keys_, bits_.size() * 64, probed, passed, probed == 0 ? 1.0 : static_cast<double>(passed) / probed);
+  }
+
+ private:
+  /** @return Bit i of the key, from two halves of its hash */
+  auto Probe(hash_t hash, uint32_t i) const -> size_t { return ((hash >> 32) + i * (hash & 0xffffffffU)) & mask_; }
+
+  auto MayContain(hash_t hash) const -> bool {
+    for (uint32_t i = 0; i < BLOOM_FILTER_HASHES; i++) {
+      const auto bit = Probe(hash, i);
+      if ((bits_[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint32_t column_;
+  std::string column_name_;
+  std::vector<uint64_t> bits_{};
+  size_t mask_{0};
+  size_t build_keys_{0};
+  std::atomic<bool> published_{false};
+  /** The rows the scan evaluated the filter on, and those that passed */
+  std::atomic<uint64_t> probed_{0};
+  std::atomic<uint64_t> passed_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.h
+//
+// Identification: src/include/execution/compiled_expression.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "storage/table/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * CompiledExpression is an expression tree translated into a flat program over typed registers. A register holds one
+ * lane per row of a batch: integers and booleans as int64_t, decimals as double, plus a null flag. Every instruction
+ * runs a tight loop over all rows, so the type dispatch happens once per batch and instruction instead of once per
+ * row and node, and no Value is created for intermediate results.
+ *
+ * Only column values of the batch's own schema, constants, comparisons, integer arithmetic and logic over numeric and
+ * boolean types are supported; Compile returns nullptr for anything else, and the caller keeps evaluating the tree.
+ * The registers are reused between batches, so a compiled expression must not be shared between threads.
+ */
+class CompiledExpression {
+ public:
+  /**
+   * Compiles an expression tree.
+   * @param expr the root of the tree
+   * @return The compiled expression, or nullptr if the tree cannot be compiled or compiling it would not help
+   */
+  static auto Compile(const AbstractExpression &expr) -> std::unique_ptr<CompiledExpression>;
+
+  /**
+   * Evaluates the expression on every selected row of a batch, like AbstractExpression::EvaluateBatch.
+   * @param batch The input rows
+   * @param[out] result The value for each selected row, in order
+   */
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result);
+
+  /**
+   * Evaluates a predicate on every selected row of a batch.
+   * @param batch The input rows
+   * @param[out] selection The positions in the column vectors, as returned by RowAt, of the rows the predicate is
+   * true for
+   */
+  void Select(const TupleBatch &batch, std::vector<uint32_t> *selection);
+
+ private:
+  /** The lane type of a register */
+  enum class RegisterType { Integer, Boolean, Decimal };
+
+  enum class OpCode { LoadColumn, LoadConstant, IntegerToDecimal, Compare, Arithmetic, And, Or };
+
+  /** An instruction writes register dst_, reading registers lhs_ and rhs_ as far as the opcode needs them. */
+  struct Instruction {
+    OpCode op_;
+    uint32_t dst_;
+    uint32_t lhs_{0};
+    uint32_t rhs_{0};
+    /** The column read by LoadColumn */
+    uint32_t column_{0};
+    /** The type of the column or constant loaded */
+    TypeId type_{TypeId::INVALID};
+    /** The constant loaded by LoadConstant */
+    std::optional<Value> constant_{};
+    ComparisonType comparison_{ComparisonType::Equal};
+    ArithmeticType arithmetic_{ArithmeticType::Plus};
+  };
+
+  struct Register {
+    RegisterType type_;
+    std::vector<int64_t> ints_{};
+    std::vector<double> decimals_{};
+    std::vector<uint8_t> nulls_{};
+  };
+
+  CompiledExpression() = default;
+
+  /** Appends the instructions computing an expression. @return The register of the result, or nullopt if unsupported */
+  auto Emit(const AbstractExpression &expr) -> std::optional<uint32_t>;
+
+  /** @return A new register of the given type */
+  auto NewRegister(RegisterType type) -> uint32_t;
+
+  /** Runs the program over the selected rows of a batch, leaving the result in the last register */
+  void Run(const TupleBatch &batch);
+
+  void LoadColumn(const Instruction &instr, const TupleBatch &batch, Register *dst);
+  void LoadConstant(const Instruction &instr, size_t rows, Register *dst);
+  void Compare(const Instruction &instr, size_t rows);
+
+  std::vector<Instruction> program_;
+  std::vector<Register> registers_;
+  /** The type of the values produced by EvaluateBatch */
+  TypeId result_type_{TypeId::INVALID};
+};
+
+}  // namespace bustub
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -20,8 +23,11 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
+#include "execution/pipeline.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/worker_pool.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 
@@ -37,10 +43,16 @@ class ExecutionEngine {
    * @param catalog The catalog used by the execution engine
    */
   ExecutionEngine(BufferPoolManager *bpm, TransactionManager *txn_mgr, Catalog *catalog)
-      : bpm_{bpm}, txn_mgr_{txn_mgr}, catalog_{catalog} {}
+      : bpm_{bpm},
+        txn_mgr_{txn_mgr},
+        catalog_{catalog},
+        worker_pool_{std::make_unique<WorkerPool>(std::max(1U, std::thread::hardware_concurrency()))} {}
 
   DISALLOW_COPY_AND_MOVE(ExecutionEngine);
 
+  /** @return The threads that run the parallel parts of queries, shared by all queries of the engine */
+  auto GetWorkerPool() -> WorkerPool * { return worker_pool_.get(); }
+
   /**
    * Execute a query plan.
    * @param plan The query plan to execute
@@ -54,15 +66,26 @@ class ExecutionEngine {
                ExecutorContext *exec_ctx) -> bool {
     BUSTUB_ASSERT((txn == exec_ctx->GetTransaction()), "Broken Invariant");
 
-    // Construct the executor for the abstract plan node
-    auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+    // Construct the pipeline the root of the plan runs in, or the executor for the abstract plan node
+    std::unique_ptr<Pipeline> pipeline;
+    std::unique_ptr<AbstractExecutor> executor;
+    if (exec_ctx->IsPushExecution()) {
+      pipeline = std::make_unique<Pipeline>(exec_ctx, plan);
+    } else {
+      executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+    }
 
     // Initialize the executor
     auto executor_succeeded = true;
 
     try {
-      executor->Init();
-      PollExecutor(executor.get(), plan, result_set);
+      if (pipeline != nullptr) {
+        pipeline->Init();
+        pipeline->Run([result_set](TupleBatch *batch) { AppendBatch(*batch, result_set); });
+      } else {
+        executor->Init();
+        PollExecutor(executor.get(), plan, result_set);
+      }
     } catch (const ExecutionException &ex) {
 #ifndef NDEBUG
       LOG_ERROR("Error Encountered in Executor Execution: %s", ex.what());
@@ -85,11 +108,17 @@ class ExecutionEngine {
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
                            std::vector<Tuple> *result_set) {
-    RID rid{};
-    Tuple tuple{};
-    while (executor->Next(&tuple, &rid)) {
-      if (result_set != nullptr) {
-        result_set->push_back(tuple);
+    TupleBatch batch{};
+    while (executor->NextBatch(&batch)) {
+      AppendBatch(batch, result_set);
+    }
+  }
+
+  /** Appends the tuples of a batch to the result set, unless it is null */
+  static void AppendBatch(const TupleBatch &batch, std::vector<Tuple> *result_set) {
+    if (result_set != nullptr) {
+      for (size_t i = 0; i < batch.Size(); i++) {
+        result_set->push_back(batch.GetTuple(i));
       }
     }
   }
@@ -97,6 +126,7 @@ class ExecutionEngine {
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] TransactionManager *txn_mgr_;
   [[maybe_unused]] Catalog *catalog_;
+  std::unique_ptr<WorkerPool> worker_pool_;
 };
 
 }  // namespace bustub
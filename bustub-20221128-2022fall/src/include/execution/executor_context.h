@@ -12,15 +12,27 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/arena.h"
 #include "concurrency/transaction.h"
+#include "execution/bloom_filter.h"
+#include "execution/morsel_queue.h"
+#include "execution/topn_cutoff.h"
+#include "execution/worker_pool.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+class AbstractPlanNode;
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -33,10 +45,18 @@ class ExecutorContext {
    * @param bpm The buffer pool manager that the executor uses
    * @param txn_mgr The transaction manager that the executor uses
    * @param lock_mgr The lock manager that the executor uses
+   * @param worker_pool The threads that run the parallel parts of the query, or `nullptr` to run it on one thread
+   * @param num_workers The number of workers a parallel part of the query is split across
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
-                  LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+                  LockManager *lock_mgr, WorkerPool *worker_pool = nullptr, size_t num_workers = 1)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        worker_pool_{worker_pool},
+        num_workers_{worker_pool == nullptr ? 1 : num_workers} {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +80,113 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the worker pool, or `nullptr` if the query runs on one thread */
+  auto GetWorkerPool() -> WorkerPool * { return worker_pool_; }
+
+  /** @return the number of workers a parallel part of the query is split across, 1 if the query is not parallel */
+  auto GetWorkerCount() const -> size_t { return num_workers_; }
+
+  /** @return the number of bytes of tuples a sort keeps in memory before it writes them to a sorted run */
+  auto GetSortMemoryBudget() const -> size_t { return sort_memory_budget_; }
+
+  /** Sets the number of bytes of tuples a sort keeps in memory, for the sorts initialized after the call */
+  void SetSortMemoryBudget(size_t budget) { sort_memory_budget_ = budget; }
+
+  /** @return the number of pages of outer tuples a nested loop join buffers per scan of its inner side */
+  auto GetNLJBlockPages() const -> size_t { return nlj_block_pages_; }
+
+  /** Sets the number of pages of outer tuples a nested loop join buffers, for the joins initialized after the call */
+  void SetNLJBlockPages(size_t pages) { nlj_block_pages_ = pages; }
+
+  /** @return whether the execution engine runs the query as push-based pipelines rather than pulling from its root */
+  auto IsPushExecution() const -> bool { return push_execution_; }
+
+  /** Sets whether the execution engine runs the query as push-based pipelines */
+  void SetPushExecution(bool push_execution) { push_execution_ = push_execution; }
+
+  /** @return the pool of memory blocks of the query, for the arenas of its executors */
+  auto GetArenaBlockPool() -> ArenaBlockPool * { return &arena_block_pool_; }
+
+  /**
+   * Makes the scan of the given plan node read its input from a morsel queue shared with other instances of the
+   * same scan, instead of reading all of it. Only scans initialized while the queue is set use it.
+   * @param plan the scan plan node
+   * @param morsels the shared queue, or `nullptr` to go back to reading the whole input
+   */
+  void SetMorselQueue(const AbstractPlanNode *plan, std::shared_ptr<MorselQueue> morsels) {
+    std::scoped_lock lock(morsel_latch_);
+    if (morsels == nullptr) {
+      morsel_queues_.erase(plan);
+    } else {
+      morsel_queues_[plan] = std::move(morsels);
+    }
+  }
+
+  /** @return the morsel queue set for the scan of the given plan node, or `nullptr` */
+  auto GetMorselQueue(const AbstractPlanNode *plan) -> std::shared_ptr<MorselQueue> {
+    std::scoped_lock lock(morsel_latch_);
+    auto it = morsel_queues_.find(plan);
+    return it == morsel_queues_.end() ? nullptr : it->second;
+  }
+
+  /**
+   * Makes the sequential scan of the given plan node drop the rows beyond the cutoff of a TopN above it. Only scans
+   * initialized while the cutoff is set use it.
+   * @param plan the scan plan node
+   * @param cutoff the cutoff, or `nullptr` to remove it
+   */
+  void SetTopNCutoff(const AbstractPlanNode *plan, std::shared_ptr<TopNCutoff> cutoff) {
+    std::scoped_lock lock(morsel_latch_);
+    if (cutoff == nullptr) {
+      topn_cutoffs_.erase(plan);
+    } else {
+      topn_cutoffs_[plan] = std::move(cutoff);
+    }
+  }
+
+  /** @return the TopN cutoff set for the scan of the given plan node, or `nullptr` */
+  auto GetTopNCutoff(const AbstractPlanNode *plan) -> std::shared_ptr<TopNCutoff> {
+    std::scoped_lock lock(morsel_latch_);
+    auto it = topn_cutoffs_.find(plan);
+    return it == topn_cutoffs_.end() ? nullptr : it->second;
+  }
+
+  /**
+   * Makes the sequential scan of the given plan node drop the rows a Bloom filter of the build side of a hash join
+   * rules out. Only scans initialized while the filter is set use it. The filter is also kept for EXPLAIN ANALYZE.
+   * @param plan the scan plan node
+   * @param filter the filter, or `nullptr` to remove it
+   */
+  void SetBloomFilter(const AbstractPlanNode *plan, std::shared_ptr<BloomFilter> filter) {
+    std::scoped_lock lock(morsel_latch_);
+    if (filter == nullptr) {
+      bloom_filters_.erase(plan);
+      return;
+    }
+    // A join that is initialized again replaces the filter it set the last time.
+    auto it = std::find_if(used_bloom_filters_.begin(), used_bloom_filters_.end(),
+                           [plan](const auto &used) { return used.first == plan; });
+    if (it == used_bloom_filters_.end()) {
+      used_bloom_filters_.emplace_back(plan, filter);
+    } else {
+      it->second = filter;
+    }
+    bloom_filters_[plan] = std::move(filter);
+  }
+
+  /** @return the Bloom filter set for the scan of the given plan node, or `nullptr` */
+  auto GetBloomFilter(const AbstractPlanNode *plan) -> std::shared_ptr<BloomFilter> {
+    std::scoped_lock lock(morsel_latch_);
+    auto it = bloom_filters_.find(plan);
+    return it == bloom_filters_.end() ? nullptr : it->second;
+  }
+
+  /** @return the last Bloom filter set for each scan, in the order they were first set */
+  auto GetUsedBloomFilters() -> std::vector<std::pair<const AbstractPlanNode *, std::shared_ptr<BloomFilter>>> {
+    std::scoped_lock lock(morsel_latch_);
+    return used_bloom_filters_;
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +198,27 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The threads that run the parallel parts of the query */
+  WorkerPool *worker_pool_;
+  /** The number of workers a parallel part of the query is split across */
+  size_t num_workers_;
+  /** The number of bytes of tuples a sort keeps in memory */
+  size_t sort_memory_budget_{SORT_MEMORY_BUDGET};
+  /** The number of pages of outer tuples a nested loop join buffers */
+  size_t nlj_block_pages_{NLJ_BLOCK_PAGES};
+  /** Whether the query runs as push-based pipelines */
+  bool push_execution_{true};
+  /** The memory blocks of the arenas of the query, freed with the context */
+  ArenaBlockPool arena_block_pool_;
+  /** Protects morsel_queues_, topn_cutoffs_ and the Bloom filters */
+  std::mutex morsel_latch_;
+  /** The morsel queues of the scans that are set up to run in parallel */
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<MorselQueue>> morsel_queues_;
+  /** The cutoffs of the TopN executors above scans */
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<TopNCutoff>> topn_cutoffs_;
+  /** The Bloom filters of the hash joins above scans */
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<BloomFilter>> bloom_filters_;
+  std::vector<std::pair<const AbstractPlanNode *, std::shared_ptr<BloomFilter>>> used_bloom_filters_;
 };
 
 }  // namespace bustub
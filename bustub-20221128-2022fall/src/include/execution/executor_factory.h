@@ -31,5 +31,15 @@ class ExecutorFactory {
    */
   static auto CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
       -> std::unique_ptr<AbstractExecutor>;
+
+  /**
+   * Creates the executor for the input of a pipeline breaker. If the input is a pipeline that can run in parallel and
+   * the query has several workers, the pipeline is run on all of them through a gather.
+   * @param exec_ctx The executor context for the created executor
+   * @param plan The input of the breaker
+   * @return An executor for the given plan in the provided context
+   */
+  static auto CreateBreakerInput(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+      -> std::unique_ptr<AbstractExecutor>;
 };
 }  // namespace bustub
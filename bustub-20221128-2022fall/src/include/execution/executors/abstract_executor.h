@@ -14,12 +14,16 @@
 
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 /**
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors can also produce their output a batch at a time through NextBatch(). A parent uses either Next() or
+ * NextBatch() on a child, never both.
  */
 class AbstractExecutor {
  public:
@@ -46,6 +50,22 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. Executors without a batch implementation fill the batch by
+   * calling Next() until it is full.
+   * @param[out] batch The batch, reset to the output schema of this executor before it is filled
+   * @return `true` if the batch holds at least one selected tuple, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool {
+    batch->Reset(&GetOutputSchema());
+    Tuple tuple{};
+    RID rid{};
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple);
+    }
+    return batch->Size() != 0;
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
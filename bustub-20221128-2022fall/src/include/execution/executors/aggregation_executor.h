@@ -12,8 +12,8 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -21,8 +21,10 @@
 #include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_partition.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
@@ -30,6 +32,11 @@ namespace bustub {
 
 /**
  * A simplified hash table that has all the necessary functionality for aggregations.
+ *
+ * The table is a flat open-addressing map in the style of a Swiss table. Every slot has a one-byte control tag that
+ * holds 7 bits of the group's hash, and probing scans the tags of eight slots at a time, so keys are only compared
+ * for slots whose tag matches. Group keys are serialized back to back into a single arena and the running aggregates
+ * of all groups live in one contiguous array, so a new group does not need heap allocations of its own.
  */
 class SimpleAggregationHashTable {
  public:
@@ -64,22 +71,13 @@ class SimpleAggregationHashTable {
   }
 
   /**
-   * TODO(Student)
-   *
    * Combines the input into the aggregation result.
    * @param[out] result The output aggregate value
    * @param input The input value
    */
   void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
     for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountStarAggregate:
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          break;
-      }
+      CombineAggregateValue(&result->aggregates_[i], i, input.aggregates_[i]);
     }
   }
 
@@ -88,56 +86,131 @@ class SimpleAggregationHashTable {
    * @param agg_key the key to be inserted
    * @param agg_val the value to be inserted
    */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
-    }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
-  }
+  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val);
+
+  /**
+   * Combines the selected rows of a batch into their groups. The group-by and aggregate expressions are evaluated one
+   * column at a time, and no intermediate AggregateKey or AggregateValue is built.
+   * @param batch the input rows
+   * @param group_bys the group by expressions
+   * @param create_group whether groups are created for rows that do not have one yet
+   * @param[out] rejected if not null, the row index and group key hash of every row that was not combined because
+   * its group does not exist and create_group is false
+   */
+  void InsertCombine(const TupleBatch &batch, const std::vector<AbstractExpressionRef> &group_bys,
+                     bool create_group = true, std::vector<std::pair<size_t, hash_t>> *rejected = nullptr);
+
+  /**
+   * Merges the groups of another table over the same aggregates into this one. The running aggregates of the other
+   * table are partial results, so its counts are added to the counts of this table rather than counted as inputs.
+   * @param other the table to merge
+   */
+  void Merge(const SimpleAggregationHashTable &other);
 
   /**
    * Clear the hash table
    */
-  void Clear() { ht_.clear(); }
+  void Clear();
+
+  /** @return The number of groups in the hash table */
+  auto Size() const -> size_t { return hashes_.size(); }
 
-  /** An iterator over the aggregation hash table */
+  /** @return The approximate number of bytes held by the groups of the hash table */
+  auto MemoryUsage() const -> size_t {
+    return ctrl_.capacity() + slots_.capacity() * sizeof(uint32_t) + hashes_.capacity() * sizeof(hash_t) +
+           key_arena_.capacity() + key_offsets_.capacity() * sizeof(uint32_t) + aggregates_.capacity() * sizeof(Value);
+  }
+
+  /** An iterator over the aggregation hash table, in the order the groups were created */
   class Iterator {
    public:
-    /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    /** Creates an iterator positioned at the given group. */
+    Iterator(const SimpleAggregationHashTable *table, size_t group) : table_{table}, group_{group} {}
 
     /** @return The key of the iterator */
-    auto Key() -> const AggregateKey & { return iter_->first; }
+    auto Key() -> AggregateKey { return table_->GetKey(group_); }
 
     /** @return The value of the iterator */
-    auto Val() -> const AggregateValue & { return iter_->second; }
+    auto Val() -> AggregateValue { return table_->GetAggregates(group_); }
 
     /** @return The iterator before it is incremented */
     auto operator++() -> Iterator & {
-      ++iter_;
+      ++group_;
       return *this;
     }
 
     /** @return `true` if both iterators are identical */
-    auto operator==(const Iterator &other) -> bool { return this->iter_ == other.iter_; }
+    auto operator==(const Iterator &other) -> bool { return this->group_ == other.group_; }
 
     /** @return `true` if both iterators are different */
-    auto operator!=(const Iterator &other) -> bool { return this->iter_ != other.iter_; }
+    auto operator!=(const Iterator &other) -> bool { return this->group_ != other.group_; }
 
    private:
-    /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    /** The table being iterated */
+    const SimpleAggregationHashTable *table_;
+    /** Index of the current group */
+    size_t group_;
   };
 
   /** @return Iterator to the start of the hash table */
-  auto Begin() -> Iterator { return Iterator{ht_.cbegin()}; }
+  auto Begin() -> Iterator { return Iterator{this, 0}; }
 
   /** @return Iterator to the end of the hash table */
-  auto End() -> Iterator { return Iterator{ht_.cend()}; }
+  auto End() -> Iterator { return Iterator{this, Size()}; }
 
  private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  /** Control tag of a slot that has never been used. Tags of full slots have the high bit cleared. */
+  static constexpr uint8_t CTRL_EMPTY = 0x80;
+  /** Number of slots whose control tags are probed together */
+  static constexpr size_t GROUP_WIDTH = 8;
+  /** Returned by FindOrInsertGroup when the group does not exist and must not be created */
+  static constexpr size_t NO_GROUP = static_cast<size_t>(-1);
+
+  /** Combines one input value into a running aggregate. */
+  void CombineAggregateValue(Value *result, uint32_t idx, const Value &input);
+
+  /** Combines the partial aggregate of another table into a running aggregate. */
+  void MergeAggregateValue(Value *result, uint32_t idx, const Value &partial);
+
+  /**
+   * @return The index of the group with the given serialized key. If there is no such group, it is created when
+   * create is true and NO_GROUP is returned otherwise.
+   */
+  auto FindOrInsertGroup(const char *key, uint32_t key_size, hash_t hash, bool create = true) -> size_t;
+
+  /** Doubles the number of slots and reinserts every group */
+  void Grow();
+
+  /** @return The group key with the values deserialized from the arena */
+  auto GetKey(size_t group) const -> AggregateKey;
+
+  /** @return A copy of the running aggregates of the group */
+  auto GetAggregates(size_t group) const -> AggregateValue;
+
+  /** Appends the serialized form of a group-by value to the buffer */
+  static void SerializeKeyValue(const Value &value, std::vector<char> *buffer);
+
+  /** @return A hash with well mixed low and high bits */
+  static auto HashKey(const char *key, uint32_t key_size) -> hash_t;
+
+  /** Control tag of each slot */
+  std::vector<uint8_t> ctrl_{};
+  /** Group index stored in each full slot */
+  std::vector<uint32_t> slots_{};
+  /** Hash of each group, kept so that growing does not rehash keys */
+  std::vector<hash_t> hashes_{};
+  /** Serialized group keys, back to back */
+  std::vector<char> key_arena_{};
+  /** Start of each group's key in the arena, plus the end of the last key */
+  std::vector<uint32_t> key_offsets_{0};
+  /** Running aggregates, agg_types_.size() consecutive values per group */
+  std::vector<Value> aggregates_{};
+  /** Scratch space the key of the current input tuple is serialized into */
+  std::vector<char> key_buffer_{};
+  /** Scratch space the group-by values of an input batch are evaluated into */
+  std::vector<std::vector<Value>> group_by_columns_{};
+  /** Scratch space the aggregate inputs of an input batch are evaluated into */
+  std::vector<std::vector<Value>> aggregate_columns_{};
   /** The aggregate expressions that we have */
   const std::vector<AbstractExpressionRef> &agg_exprs_;
   /** The types of aggregations that we have */
@@ -147,6 +220,15 @@ class SimpleAggregationHashTable {
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * The groups are kept in memory until the hash table reaches AGGREGATION_MEMORY_BUDGET. After that, input tuples of
+ * groups already in the table are still combined in place, while tuples of new groups are hash partitioned and
+ * written to temporary pages through the buffer pool. Once the in-memory groups have been produced, every partition
+ * is aggregated on its own in the same way, partitioning it again on other hash bits if it is still too large.
+ *
+ * If the child runs on several workers through a gather, every worker pre-aggregates the batches it produces into a
+ * table of its own, within an equal share of the budget. The tables are merged once the input is exhausted, and the
+ * rows the workers could not fit are then aggregated against the merged table like any other input.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -170,6 +252,13 @@ class AggregationExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the aggregation.
+   * @param[out] batch The next tuples produced by the aggregation
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the aggregation */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -196,13 +285,43 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  /** Input tuples of a set of groups that did not fit in memory */
+  struct SpillPartition {
+    /** The spilled tuples */
+    std::unique_ptr<TmpTuplePartition> tuples_;
+    /** How many times the input was partitioned to produce this partition */
+    uint32_t depth_;
+  };
+
+  /**
+   * Builds the hash table from a stream of input tuples, spilling tuples of new groups once the table is over budget.
+   * @param next produces the next batch of input tuples, returns false at the end of the input
+   * @param depth the partitioning depth of the input
+   */
+  void Aggregate(const std::function<bool(TupleBatch *)> &next, uint32_t depth);
+
+  /** Builds the hash table from the thread-local tables of the workers of gather_ */
+  void AggregateParallel();
+
+  /** Produces the values of the next output row. @return false if there are no more rows */
+  auto NextRow(std::vector<Value> *values) -> bool;
+
+  /** Loads the next spilled partition into the hash table, deleting its pages. @return false if there is none */
+  auto AggregateNextPartition() -> bool;
+
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
+  /** The child if it is a gather, whose workers then pre-aggregate in parallel */
+  GatherExecutor *gather_;
   /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
+  SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
+  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** Spilled partitions that still have to be aggregated */
+  std::vector<SpillPartition> partitions_{};
+  /** Whether the single output row of an aggregation without groups over empty input has been produced */
+  bool empty_result_emitted_{false};
 };
 }  // namespace bustub
@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/filter_plan.h"
@@ -48,14 +49,35 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the filter. The rows of the child's batch that do not satisfy the predicate
+   * are dropped through the batch's selection vector.
+   * @param[out] batch The next tuples produced by the filter
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /**
+   * Narrows a batch down to the rows that satisfy the predicate of a filter plan, through its selection vector.
+   * @param plan the filter plan
+   * @param compiled_predicate the predicate of the plan as compiled by CompiledExpression::Compile, or nullptr
+   * @param[in,out] batch the rows to filter
+   * @return `true` if any row satisfies the predicate; the batch is left as it is otherwise
+   */
+  static auto FilterBatch(const FilterPlanNode &plan, CompiledExpression *compiled_predicate, TupleBatch *batch)
+      -> bool;
+
  private:
   /** The filter plan node to be executed */
   const FilterPlanNode *plan_;
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The predicate compiled by Init, or nullptr if it cannot be compiled */
+  std::unique_ptr<CompiledExpression> compiled_predicate_;
 };
 }  // namespace bustub
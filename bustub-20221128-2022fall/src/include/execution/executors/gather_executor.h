@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/pipeline.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * GatherExecutor runs a pipeline, a chain of filters and projections over a table or mock scan, on all workers of
+ * the executor context. Every worker runs its own instance of the pipeline push-based, and the scans of the instances
+ * take their input from a shared morsel queue.
+ *
+ * The executor factory puts a gather below pipeline breakers (aggregations, hash joins, sorts and top-Ns) whose
+ * input is such a pipeline. A breaker can read the gathered batches through Next/NextBatch like from any other child,
+ * in which case the workers hand their batches over through a small queue, or it can consume the batches on the
+ * workers themselves through RunOnWorkers and merge its thread-local state afterwards. A hash join can also put its
+ * probe on top of the pipeline of every worker, in which case the gather outputs the joined batches. There is no plan
+ * node for a
+ * gather, so it does not show up in EXPLAIN. The order of the gathered rows is not deterministic.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new GatherExecutor instance.
+   * @param exec_ctx The executor context, which must have a worker pool
+   * @param plan The root of the pipeline to run on the workers
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan);
+
+  /** Stops the workers if they are still running. */
+  ~GatherExecutor() override;
+
+  /** @return `true` if the plan is a pipeline that a GatherExecutor can run on several workers */
+  static auto IsParallelPipeline(const AbstractPlanNode &plan) -> bool;
+
+  /** Initialize the pipeline instances of all workers */
+  void Init() override;
+
+  /**
+   * Yield the next tuple produced by any of the workers.
+   * @param[out] tuple The next tuple produced by the pipeline
+   * @param[out] rid The next tuple RID produced by the pipeline
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch produced by any of the workers.
+   * @param[out] batch The next tuples produced by the pipeline
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /**
+   * Runs the pipeline on the workers and hands every batch to the sink on the worker that produced it. Returns when
+   * all workers are done, rethrowing the first exception a worker or the sink threw. Must be called instead of, not
+   * in addition to, Next/NextBatch.
+   * @param sink called with the index of the worker and the batch, concurrently for different workers
+   */
+  void RunOnWorkers(const std::function<void(size_t, TupleBatch *)> &sink);
+
+  /**
+   * Puts an operator on top of the pipeline of every worker, so that the gather outputs what the operators emit.
+   * @param make_operator creates the operator of a worker, called with the index of the worker in every Init
+   * @param output_schema the schema of the batches the operators emit
+   */
+  void SetWorkerOperator(std::function<std::unique_ptr<PipelineOperator>(size_t)> make_operator,
+                         const Schema *output_schema);
+
+  /** @return The number of workers the pipeline runs on */
+  auto GetWorkerCount() const -> size_t { return pipelines_.size(); }
+
+  /** @return The output schema of the pipeline, with the operators added on top of it */
+  auto GetOutputSchema() const -> const Schema & override {
+    return output_schema_ != nullptr ? *output_schema_ : plan_->OutputSchema();
+  }
+
+ private:
+  /** Submits one task per worker, each running its pipeline instance into the sink */
+  void Start(const std::function<void(size_t, TupleBatch *)> &sink);
+
+  /** Tells the workers to stop and waits for them */
+  void Stop();
+
+  /** Runs the pipeline instance of one worker until it is exhausted or the gather is stopped */
+  void RunPipeline(size_t worker, const std::function<void(size_t, TupleBatch *)> &sink);
+
+  /** Hands a batch over to the consumer of Next/NextBatch, waiting while the queue is full */
+  void Push(TupleBatch *batch);
+
+  /** The root of the pipeline */
+  AbstractPlanNodeRef plan_;
+  /** Creates the operator added on top of the pipeline of every worker, if any, and the schema of its output */
+  std::function<std::unique_ptr<PipelineOperator>(size_t)> make_worker_operator_{};
+  const Schema *output_schema_{nullptr};
+  /** One instance of the pipeline per worker */
+  std::vector<std::unique_ptr<Pipeline>> pipelines_;
+  /** Completion of the task of each worker */
+  std::vector<std::future<void>> workers_;
+  /** The sink the workers run into when the batches are consumed through Next/NextBatch */
+  std::function<void(size_t, TupleBatch *)> push_sink_;
+
+  /** Protects the members below */
+  std::mutex latch_;
+  /** Signaled when a batch is queued or taken, and when a worker finishes */
+  std::condition_variable cv_;
+  /** Batches produced by the workers and not taken yet */
+  std::deque<TupleBatch> batches_;
+  /** The number of workers that have not finished yet */
+  size_t running_{0};
+  /** Whether the workers have been started since the last Init */
+  bool started_{false};
+  /** Set to make the workers stop early */
+  std::atomic<bool> stopped_{false};
+  /** The first exception thrown by a worker */
+  std::exception_ptr error_;
+
+  /** The batch Next serves tuples from */
+  TupleBatch current_{};
+  /** The next row of current_ served by Next */
+  size_t current_row_{0};
+};
+
+}  // namespace bustub
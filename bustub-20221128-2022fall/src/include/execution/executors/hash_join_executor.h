@@ -12,18 +12,47 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "common/util/hash_util.h"
+#include "execution/bloom_filter.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_partition.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes a hybrid hash JOIN on two tables.
+ *
+ * The right child is the build side. Its tuples are hash partitioned on the join key into HASH_JOIN_PARTITIONS
+ * partitions, all of them in memory at first. Whenever the build tuples in memory exceed HASH_JOIN_MEMORY_BUDGET, the
+ * largest in-memory partition is written to temporary pages through the buffer pool, so as many partitions as fit stay
+ * in memory. Every in-memory partition then gets a hash table of its own. Left tuples of in-memory partitions are
+ * joined right away, the others are written next to their build partition. Every spilled pair of partitions is then
+ * joined the same way, partitioning again on other hash bits, so a partition that is still too large is split further.
+ *
+ * When the right child is a GatherExecutor, every worker partitions the batches it produces into partitions of its
+ * own, with a share of the memory budget, and the partitions of all workers are merged into one hash table per
+ * partition in parallel afterwards, so the workers never contend for a table. When the left child is a
+ * GatherExecutor, the workers probe the hash tables themselves, on top of the pipeline they run, and the join outputs
+ * the batches they gather. The spilled partitions are joined by the thread of the join.
+ *
+ * When the left join key is a column that comes from a sequential scan, the join of an inner join hands a Bloom filter
+ * to the scan, and publishes it with the hashes of the build keys once the build phase is done. The scan then drops
+ * most left tuples without a match before they are materialized and probed.
+ *
+ * In a push-based pipeline, the join has no left child: the pipeline initializes it through InitBuild, pushes the
+ * probe batches into Probe and calls FinishProbe once they are all pushed.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -31,7 +60,8 @@ class HashJoinExecutor : public AbstractExecutor {
    * Construct a new HashJoinExecutor instance.
    * @param exec_ctx The executor context
    * @param plan The HashJoin join plan to be executed
-   * @param left_child The child executor that produces tuples for the left side of join
+   * @param left_child The child executor that produces tuples for the left side of join, or nullptr if the join is
+   * probed by a pipeline
    * @param right_child The child executor that produces tuples for the right side of join
    */
   HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
@@ -40,6 +70,33 @@ class HashJoinExecutor : public AbstractExecutor {
   /** Initialize the join */
   void Init() override;
 
+  /**
+   * Builds the hash table, for a join that is probed by a pipeline instead of its left child.
+   * @param init_probe_side initializes the probe side, called while the Bloom filter for its scan, if any, is set
+   */
+  void InitBuild(const std::function<void()> &init_probe_side);
+
+  /**
+   * Makes the workers of the gather that produces the probe tuples probe the hash table, so that the gather outputs
+   * joined tuples. Must be called before the gather is initialized.
+   * @param gather the probe side of a join that is probed by a pipeline
+   */
+  void ProbeOnWorkers(GatherExecutor *gather);
+
+  /**
+   * Joins a batch of probe tuples pushed by a pipeline, or passes on a batch joined by the workers of the gather the
+   * join probes on.
+   * @param probe the probe tuples, which the join takes over
+   * @param emit called with every full batch of joined tuples, which it may modify
+   */
+  void Probe(TupleBatch *probe, const std::function<void(TupleBatch *)> &emit);
+
+  /**
+   * Emits the joined tuples that are left once all probe tuples have been pushed, joining the spilled partitions.
+   * @param emit called with every batch of joined tuples, which it may modify
+   */
+  void FinishProbe(const std::function<void(TupleBatch *)> &emit);
+
   /**
    * Yield the next tuple from the join.
    * @param[out] tuple The next tuple produced by the join.
@@ -48,12 +105,171 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  class WorkerProbeOperator;
+
+  /** Build tuples of one partition, by join key hash */
+  using HashTable = std::unordered_multimap<hash_t, Tuple>;
+
+  /** The build tuples of one partition of a pass that one worker, or the thread of the join, partitioned */
+  struct BuildPartition {
+    /** Build tuples kept in memory with the hash of their join key, empty once the partition is spilled */
+    std::vector<std::pair<hash_t, Tuple>> tuples_{};
+    /** Holds the data of the build tuples in memory */
+    Arena arena_{};
+    /** Bytes held by tuples_ */
+    size_t memory_usage_{0};
+    /** Build tuples on temporary pages, null until the partition is spilled */
+    std::unique_ptr<TmpTuplePartition> spilled_{};
+  };
+
+  /** The build tuples one worker, or the thread of the join, partitioned */
+  struct BuildShard {
+    std::vector<BuildPartition> partitions_{};
+    /** Bytes held by the partitions */
+    size_t memory_usage_{0};
+    /** The join key hashes of the build tuples, for the Bloom filter */
+    std::vector<hash_t> hashes_{};
+    /** Scratch space for the join keys of a batch */
+    std::vector<Value> keys_{};
+  };
+
+  /** One partition of a pass, once the build tuples of all shards are merged */
+  struct Partition {
+    /** The build tuples, empty if the partition is spilled */
+    HashTable table_{};
+    /** Hold the data of the build tuples, which the hash table points to until the next pass */
+    std::vector<Arena> arenas_{};
+    /** Build tuples on temporary pages, null while the partition is in memory */
+    std::unique_ptr<TmpTuplePartition> spilled_build_{};
+  };
+
+  /** A pair of spilled partitions that still has to be joined */
+  struct Pass {
+    std::unique_ptr<TmpTuplePartition> build_;
+    std::unique_ptr<TmpTuplePartition> probe_;
+    /** How many times the inputs were partitioned to produce this pass */
+    uint32_t depth_;
+  };
+
+  /** The state of a thread that probes the hash tables */
+  struct ProbeState {
+    /** The probe tuples being joined */
+    TupleBatch probe_batch_{};
+    /** The join key of each probe tuple */
+    std::vector<Value> probe_keys_{};
+    /** The probe row being joined */
+    size_t probe_row_{0};
+    /** Build tuples of the current probe row that have not been compared yet */
+    HashTable::const_iterator match_begin_{};
+    HashTable::const_iterator match_end_{};
+    /** Whether the current probe row still needs a row padded with nulls when it has no match */
+    bool pad_probe_row_{false};
+    /** Scratch space output rows are assembled in */
+    std::vector<Value> output_values_{};
+    /** The batch joined probe tuples are pushed in */
+    TupleBatch output_batch_{};
+    /** Probe tuples of the spilled partitions, by partition, null until the first tuple of the partition */
+    std::vector<std::unique_ptr<TmpTuplePartition>> spilled_probe_{};
+  };
+
+  /** @return The filter the probe side scan can apply, after setting it for the scan in the context, or nullptr */
+  auto MakeBloomFilter() -> std::shared_ptr<BloomFilter>;
+
+  /** Partitions the build tuples of a pass and builds the hash tables of the partitions that stay in memory */
+  void Build(const std::function<bool(TupleBatch *)> &next, uint32_t depth);
+
+  /** Partitions the build tuples of the first pass on the workers of the right child */
+  void BuildParallel();
+
+  /** Resets the partitions for a pass at the given depth. @return a shard for each of the given number of threads */
+  auto StartBuild(uint32_t depth, size_t num_shards) -> std::vector<BuildShard>;
+
+  /** Adds a batch of build tuples to the partitions of a shard, spilling some if the shard exceeds the budget */
+  void PartitionBuildBatch(BuildShard *shard, const TupleBatch &batch, size_t memory_budget);
+
+  /** Writes the build tuples of a partition in memory to temporary pages. @return the bytes freed */
+  auto SpillBuildPartition(BuildPartition *partition) -> size_t;
+
+  /** Merges the shards into the partitions, building a hash table for every partition that is not spilled */
+  void FinishBuild(std::vector<BuildShard> *shards);
+
+  /** Fills the batch with joined tuples. @return false if there are no more tuples */
+  auto FillBatch(TupleBatch *batch) -> bool;
+
+  /** Joins a batch of probe tuples, emitting every batch of joined tuples that gets full */
+  void ProbeBatch(ProbeState *state, TupleBatch *probe, const std::function<void(TupleBatch *)> &emit);
+
+  /** Appends joined tuples to the batch until it is full or the rows of the probe batch run out */
+  void JoinProbeRows(ProbeState *state, TupleBatch *batch);
+
+  /** Reads the next probe batch, moving on to the next pass when needed. @return false if the join is done */
+  auto NextProbeBatch() -> bool;
+
+  /** Looks up the matches of the current probe row, or spills it if its partition is not in memory */
+  void StartProbeRow(ProbeState *state);
+
+  /** Queues the spilled partitions of the finished pass. @return false if there is no pass left to start */
+  auto StartNextPass() -> bool;
+
+  /** @return The partition of a join key hash at the given depth */
+  static auto PartitionOf(hash_t hash, uint32_t depth) -> size_t;
+
+  /**
+   * @return The join key hash, with bits that can be used both for partitioning and by the hash table, and the same
+   * as the one of the Bloom filter
+   */
+  static auto HashJoinKey(const Value &key) -> hash_t { return BloomFilter::HashKey(key); }
+
+  /** Appends the current probe row joined with the right tuple, or with nulls if right_tuple is null */
+  void AppendOutputRow(ProbeState *state, TupleBatch *batch, const Tuple *right_tuple);
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The probe side, null if the join is probed by a pipeline */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The build side */
+  std::unique_ptr<AbstractExecutor> right_child_;
+  /** The build side if it runs on workers, or nullptr */
+  GatherExecutor *build_gather_;
+  /** The probe side if its workers probe the hash tables, or nullptr */
+  GatherExecutor *probe_gather_{nullptr};
+  /** The filter of the build keys handed to the probe side scan, or nullptr, and that scan */
+  std::shared_ptr<BloomFilter> bloom_filter_{};
+  const AbstractPlanNode *bloom_filter_scan_{nullptr};
+  /** Partitions of the current pass */
+  std::vector<Partition> partitions_{};
+  /** Whether each partition of the current pass is spilled, set by the shard that spills it first */
+  std::array<std::atomic<bool>, HASH_JOIN_PARTITIONS> spilled_{};
+  /** Partitioning depth of the current pass */
+  uint32_t depth_{0};
+  /** The current pass, unless it reads its inputs from the children */
+  Pass pass_{};
+  /** Produces the probe tuples of the current pass */
+  std::function<bool(TupleBatch *)> probe_next_{};
+  /** Spilled partitions waiting to be joined */
+  std::vector<Pass> pending_passes_{};
+
+  /** The probe state of the thread of the join */
+  ProbeState probe_{};
+  /** The probe state of each worker of probe_gather_ */
+  std::vector<ProbeState> worker_probes_{};
+  /** Whether the joined batches of probe_gather_ are still being read */
+  bool gathering_{false};
+
+  /** The batch Next() returns tuples from */
+  TupleBatch output_batch_{};
+  size_t output_index_{0};
 };
 
 }  // namespace bustub
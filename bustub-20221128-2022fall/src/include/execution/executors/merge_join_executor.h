@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor executes a sort-merge JOIN on two inputs that are already sorted on their join keys.
+ *
+ * Both children are read once, in step. For every left tuple the right input is advanced past the smaller keys, and
+ * the right tuples with a key equal to the left one are collected into a group, which is joined with every left tuple
+ * of that key, so duplicate keys on both sides are handled without rereading the right input. No hash table is built,
+ * and the executor only holds one batch of each input and the current right group in memory.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The merge join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join, sorted on the left key
+   * @param right_child The child executor that produces tuples for the right side of join, sorted on the right key
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join.
+   * @param[out] rid The next tuple RID, not used by merge join.
+   * @return `true` if a tuple was produced, `false` if there are no more tuples.
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema for the join */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** Fills the batch with joined tuples. @return false if there are no more tuples */
+  auto FillBatch(TupleBatch *batch) -> bool;
+
+  /** Moves the right input to the group of the key of the current left row, if there is one */
+  void StartLeftRow();
+
+  /** Makes sure the current right row is valid, reading the next right batch if needed. @return false at the end */
+  auto RightRowValid() -> bool;
+
+  /** Appends the current left row joined with the right tuple, or with nulls if right_tuple is null */
+  void AppendOutputRow(TupleBatch *batch, const Tuple *right_tuple);
+
+  /** The merge join plan node to be executed */
+  const MergeJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_child_;
+  std::unique_ptr<AbstractExecutor> right_child_;
+
+  /** The left tuples being joined, with their join keys */
+  TupleBatch left_batch_{};
+  std::vector<Value> left_keys_{};
+  /** The left row being joined */
+  size_t left_row_{0};
+  /** Whether StartLeftRow was called for the current left row */
+  bool left_row_started_{false};
+  bool left_done_{false};
+
+  /** The right tuples not joined yet, with their join keys */
+  TupleBatch right_batch_{};
+  std::vector<Value> right_keys_{};
+  size_t right_row_{0};
+  bool right_done_{false};
+
+  /** The key of the right group, if there is one */
+  std::optional<Value> group_key_{};
+  /** The right tuples with the key group_key_; a deque, so that tuples are never copied as it grows */
+  std::deque<Tuple> group_{};
+  /** Holds the data of the tuples of the group, reset for every group */
+  Arena group_arena_;
+  /** Whether the current left row matches the group */
+  bool group_matches_{false};
+  /** The next tuple of the group to join with the current left row */
+  size_t group_index_{0};
+  /** Scratch space output rows are assembled in */
+  std::vector<Value> output_values_{};
+
+  /** The batch Next() returns tuples from */
+  TupleBatch output_batch_{};
+  size_t output_index_{0};
+};
+
+}  // namespace bustub
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -25,9 +27,13 @@ namespace bustub {
 
 extern const char *mock_table_list[];
 auto GetMockTableSchemaOf(const std::string &table) -> Schema;
+auto GetSizeOf(const MockScanPlanNode *plan) -> size_t;
 
 /**
  * The MockScanExecutor executor executes a sequential table scan for tests.
+ *
+ * If a morsel queue is set for the plan node in the executor context when the scan is initialized, the scan only
+ * produces the rows it takes from the queue, in their unshuffled order.
  */
 class MockScanExecutor : public AbstractExecutor {
  public:
@@ -49,10 +55,20 @@ class MockScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The next tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** Moves the cursor to the next row to produce. @return false at the end of the scan */
+  auto Advance() -> bool;
+
   /** @return A dummy tuple according to the output schema */
   auto MakeDummyTuple() const -> Tuple;
 
@@ -71,8 +87,14 @@ class MockScanExecutor : public AbstractExecutor {
   /** The cursor for the current mock scan */
   std::size_t cursor_{0};
 
+  /** One past the last row the scan produces before it has to take the next morsel */
+  std::size_t end_{0};
+
+  /** The morsel queue shared with other instances of the scan, set by Init if the scan runs in parallel */
+  std::shared_ptr<MorselQueue> morsels_;
+
   /** The table function */
-  std::function<Tuple(std::size_t)> func_;
+  std::function<std::vector<Value>(std::size_t)> func_;
 
   /** The size of the mock table */
   std::size_t size_;
@@ -12,12 +12,14 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -29,6 +31,11 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * The outer tuples are joined a batch at a time: the keys of a batch are sorted, and the index is probed once for every
+ * distinct key, in key order. Neighbouring probes then touch neighbouring index pages, which are likely still in the
+ * buffer pool, and a key that repeats in the batch is only looked up once. The output keeps the order of the outer
+ * tuples.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -47,8 +54,46 @@ class NestIndexJoinExecutor : public AbstractExecutor {
 
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
  private:
+  /** Fills the batch with joined tuples. @return false if there are no more tuples */
+  auto FillBatch(TupleBatch *batch) -> bool;
+
+  /** Reads the next outer batch and probes the index for its keys. @return false if there are no more outer tuples */
+  auto ProbeOuterBatch() -> bool;
+
+  /** Appends an outer tuple joined with an inner tuple, or with nulls if inner_tuple is null */
+  void AppendOutputRow(TupleBatch *batch, const Tuple &outer_tuple, const Tuple *inner_tuple);
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *table_info_{nullptr};
+
+  /** The current batch of outer tuples */
+  TupleBatch outer_batch_{};
+  std::vector<Tuple> outer_tuples_{};
+  /** Holds the data of the outer tuples, reset for every batch */
+  Arena outer_arena_;
+  bool outer_done_{false};
+  /** The keys of the outer tuples, and the rows with a non-null key in key order */
+  std::vector<Value> keys_{};
+  std::vector<uint32_t> sorted_rows_{};
+  /** The inner tuples matching each distinct key of the batch, and the range of them each outer row joins with */
+  std::deque<Tuple> inner_tuples_{};
+  std::vector<std::pair<size_t, size_t>> row_matches_{};
+  std::vector<RID> rids_{};
+
+  /** The outer row and the inner tuple to output next */
+  size_t outer_row_{0};
+  size_t match_index_{0};
+  /** Scratch space output rows are assembled in */
+  std::vector<Value> output_values_{};
+
+  /** The batch Next() returns tuples from */
+  TupleBatch output_batch_{};
+  size_t output_index_{0};
 };
 }  // namespace bustub
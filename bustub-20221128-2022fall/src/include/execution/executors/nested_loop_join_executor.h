@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -24,6 +26,11 @@ namespace bustub {
 
 /**
  * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ *
+ * The join is a block nested loop: it buffers as many left tuples as fit in the number of pages set in the executor
+ * context, and then scans the right child once for the whole block, evaluating the predicate of every right tuple
+ * against every tuple of the block. The right child is thus rescanned once per block rather than once per left tuple.
+ * For a left join, the block tuples without a match are padded with nulls once the scan of the right child is done.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -49,12 +56,62 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the insert */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Fills the batch with joined tuples. @return false if there are no more tuples */
+  auto FillBatch(TupleBatch *batch) -> bool;
+
+  /** Buffers the next block of left tuples and starts a scan of the right child. @return false if there are none */
+  auto LoadBlock() -> bool;
+
+  /** Reads the next batch of the right child. @return false at the end of the scan */
+  auto NextRightBatch() -> bool;
+
+  /** Appends a left tuple joined with the right tuple, or with nulls if right_tuple is null */
+  void AppendOutputRow(TupleBatch *batch, const Tuple &left_tuple, const Tuple *right_tuple);
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The left tuples of the current block; a deque, so that tuples are never copied as it grows */
+  std::deque<Tuple> block_{};
+  /** Holds the data of the tuples of the block, reset for every block */
+  Arena block_arena_;
+  /** Whether each tuple of the block matched a right tuple, for left joins */
+  std::vector<bool> block_matched_{};
+  /** The left batch the block is read from, which may hold tuples for the next block */
+  TupleBatch left_batch_{};
+  size_t left_row_{0};
+  bool left_done_{false};
+
+  /** The tuples of the current right batch */
+  TupleBatch right_batch_{};
+  std::vector<Tuple> right_tuples_{};
+  /** Holds the data of the right tuples, reset for every right batch */
+  Arena right_arena_;
+  bool right_done_{true};
+  /** The right tuple and block tuple to compare next */
+  size_t right_row_{0};
+  size_t block_index_{0};
+  /** The next block tuple to check for padding, once the scan of the right child is done */
+  size_t pad_index_{0};
+  /** Scratch space output rows are assembled in */
+  std::vector<Value> output_values_{};
+
+  /** The batch Next() returns tuples from */
+  TupleBatch output_batch_{};
+  size_t output_index_{0};
 };
 
 }  // namespace bustub
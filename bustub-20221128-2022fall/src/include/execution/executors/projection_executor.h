@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/projection_plan.h"
@@ -47,14 +48,39 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the projection, computing each output column over the whole batch.
+   * @param[out] batch The next tuples produced by the projection
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /**
+   * Computes the expressions of a projection plan over a batch, one output column at a time.
+   * @param plan the projection plan
+   * @param compiled_exprs the expressions of the plan as compiled by CompiledExpression::Compile, nullptr for those
+   * that are evaluated as they are
+   * @param input the rows to project
+   * @param[out] output the projected rows, reset to the output schema of the plan
+   */
+  static void ProjectBatch(const ProjectionPlanNode &plan,
+                           const std::vector<std::unique_ptr<CompiledExpression>> &compiled_exprs,
+                           const TupleBatch &input, TupleBatch *output);
+
  private:
   /** The projection plan node to be executed */
   const ProjectionPlanNode *plan_;
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The batch the child's tuples are read into by NextBatch */
+  TupleBatch child_batch_{};
+
+  /** The expressions compiled by Init, nullptr for those that are evaluated as they are */
+  std::vector<std::unique_ptr<CompiledExpression>> compiled_exprs_;
 };
 }  // namespace bustub
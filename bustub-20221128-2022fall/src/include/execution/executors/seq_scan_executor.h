@@ -12,17 +12,35 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <vector>
 
+#include "execution/bloom_filter.h"
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/filter_kernels.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/topn_cutoff.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * If a morsel queue is set for the plan node in the executor context when the scan is initialized, the scan only
+ * reads the pages it takes from the queue, so several instances of it can share the table between threads.
+ *
+ * The scan copies every page it reads at once, and its tuples point into the copy rather than owning their data, so
+ * they are only materialized as values of the batch, or as tuples of their own by Next.
+ *
+ * NextBatch evaluates the comparisons of INTEGER, BIGINT and DECIMAL columns with constants in the filter predicate
+ * on the raw tuples with SIMD kernels, and only materializes the tuples that pass them. The same goes for the cutoff
+ * of a TopN above the scan, and the Bloom filter of a hash join the scan is the probe side of, if they are set for
+ * the plan node in the executor context when the scan is initialized.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -44,11 +62,65 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The next tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /**
+   * Follows a column of the output of a plan down through projections and filters to the sequential scan it comes
+   * from, for the executors that hand filters down to the scan.
+   * @param plan the plan node
+   * @param[in,out] column the index of the column in the output of the plan, then in the schema of the table
+   * @return The scan plan node, or nullptr if the column does not come straight from a scan
+   */
+  static auto FindScanOfColumn(const AbstractPlanNode *plan, uint32_t *column) -> const SeqScanPlanNode *;
+
  private:
+  /** Reads the next tuple of the morsels taken by this scan, pointing into a page copy. @return false at the end */
+  auto NextTuple(Tuple *tuple) -> bool;
+
+  /** Makes the page copies available again, except the one of the current page, once no tuple points into them */
+  void RecyclePageCopies();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned */
+  TableInfo *table_info_{nullptr};
+  /** The morsel queue, shared with other instances of the scan if the scan runs in parallel, set by Init */
+  std::shared_ptr<MorselQueue> morsels_{};
+  /** The current morsel, as positions in morsels_ */
+  size_t morsel_page_{0};
+  size_t morsel_end_{0};
+  /** The tuples of the current page of the morsel */
+  std::vector<Tuple> page_tuples_{};
+  /** Copies of the pages read since the last RecyclePageCopies, the last one being the current page, and spare ones */
+  std::vector<std::unique_ptr<char[]>> page_copies_{};
+  size_t page_copies_used_{0};
+  /** The next tuple of page_tuples_ */
+  size_t page_tuple_index_{0};
+  /** The comparisons of the filter predicate that NextBatch evaluates on the raw tuples */
+  std::vector<ColumnConstantFilter> kernel_filters_;
+  /** The rest of the filter predicate, evaluated on the materialized batch, or nullptr if there is none */
+  AbstractExpressionRef residual_predicate_;
+  /** The residual predicate compiled by Init, or nullptr if there is none or it cannot be compiled */
+  std::unique_ptr<CompiledExpression> compiled_predicate_;
+  /** The cutoff of the TopN above the scan, or nullptr */
+  std::shared_ptr<TopNCutoff> cutoff_;
+  /** The version of cutoff_ that cutoff_filter_ was made from */
+  uint64_t cutoff_version_{0};
+  /** The filter for the current bound of cutoff_, applied after kernel_filters_ */
+  std::optional<ColumnConstantFilter> cutoff_filter_;
+  /** The Bloom filter of the hash join above the scan, or nullptr */
+  std::shared_ptr<BloomFilter> bloom_filter_;
+  /** The tuples read for the next batch, before they are filtered */
+  std::vector<Tuple> tuples_;
+  /** The tuples that pass kernel_filters_, one bit per tuple of tuples_ */
+  std::vector<uint64_t> bitmap_;
 };
 }  // namespace bustub
@@ -12,19 +12,40 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/gather_executor.h"
+#include "execution/loser_tree.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "execution/sort_key.h"
+#include "storage/table/tmp_tuple_partition.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * The SortExecutor executor executes a sort.
+ * The SortExecutor executes a sort as an external merge sort.
+ *
+ * Input tuples are collected in memory together with their normalized sort keys. Whenever they take more than the sort
+ * memory budget of the executor context, they are sorted and written to a sorted run on temporary pages through the
+ * buffer pool. Once the input is exhausted, the runs are merged with a loser tree, at most SORT_MERGE_FAN_IN at a
+ * time, until the runs left and the tuples still in memory can be merged in one pass while the output is produced.
+ * A sort whose input fits in the budget never touches the buffer pool.
+ *
+ * With several workers, every step but the final merge runs in parallel. If the child is a gather, each worker
+ * collects the tuples it produces in a chunk of its own, within an equal share of the budget, and writes its own runs.
+ * The tuples left in memory are cut into slices that are sorted in parallel, and the slices are merged in parallel
+ * into one sorted array: splitter keys sampled from the slices divide the key range into one part per worker, and
+ * each worker merges the ranges of all slices that fall into its part into its own section of the array. Groups of
+ * runs are merged in parallel as well, as far as the frames of the buffer pool allow.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -50,7 +71,104 @@ class SortExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** An input tuple in memory, with its normalized sort key */
+  struct SortEntry {
+    /** Builds the tuple of a row of a batch in the arena of the chunk */
+    SortEntry(std::string &&key, const TupleBatch &batch, size_t row, Arena *arena)
+        : key_{std::move(key)}, tuple_{batch.GetTuple(row, arena)} {}
+
+    std::string key_;
+    Tuple tuple_;
+  };
+
+  /** The input tuples collected in memory by one worker */
+  struct SortChunk {
+    SortChunk(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys, ArenaBlockPool *pool)
+        : encoder_{order_bys}, arena_{pool} {}
+
+    SortKeyEncoder encoder_;
+    /** The keys of the batch being added */
+    std::vector<std::string> keys_{};
+    /** The tuples; a deque, so that tuples are never copied as it grows */
+    std::deque<SortEntry> entries_{};
+    /** Holds the data of the tuples until they are written to a run */
+    Arena arena_;
+    /** The bytes taken by the tuples */
+    size_t memory_usage_{0};
+  };
+
+  /** A sequence of tuples in memory in sort order */
+  using SortedEntries = std::vector<const SortEntry *>;
+
+  /** The read position in a sorted run that takes part in a merge */
+  struct RunCursor {
+    /** The run on temporary pages, or nullptr for the sorted tuples in memory */
+    std::unique_ptr<TmpTuplePartition> run_;
+    /** The index in sorted_ of the next tuple, for the run in memory */
+    size_t position_{0};
+    /** The head of the run, or nullptr once the run is exhausted */
+    const std::string *key_{nullptr};
+    const Tuple *tuple_{nullptr};
+    /** The head of a run on temporary pages */
+    std::string key_buffer_{};
+    Tuple tuple_buffer_{};
+  };
+
+  /** Adds the rows of a batch to a chunk, and writes the chunk to a run if it goes over the budget */
+  void AddBatch(SortChunk *chunk, const TupleBatch &batch, size_t budget);
+
+  /** Sorts the tuples of a chunk and writes them to a new run, freeing their memory */
+  void WriteRun(SortChunk *chunk);
+
+  /** @return The tuples of a chunk in sort order */
+  static auto SortChunkEntries(const SortChunk &chunk) -> SortedEntries;
+
+  /** Sorts the tuples left in the chunks into sorted_, in parallel */
+  void SortInMemory();
+
+  /** Merges sorted sequences into sorted_, one part of the key range per worker */
+  void MergeInMemory(const std::vector<SortedEntries> &slices);
+
+  /** Merges groups of runs until they can be merged with sorted_ in one pass */
+  void MergeRuns();
+
+  /** @return A run with the tuples of the given runs */
+  auto MergeRunGroup(std::vector<std::unique_ptr<TmpTuplePartition>> runs) -> std::unique_ptr<TmpTuplePartition>;
+
+  /** Makes the next tuple of a run its head */
+  void Advance(RunCursor *cursor);
+
+  /** @return true if the head of run a comes before the head of run b, where exhausted runs come last */
+  static auto HeadBefore(const std::vector<RunCursor> &cursors, size_t a, size_t b) -> bool;
+
+  /** Reads the first tuple of every run of a merge and plays the tree */
+  void StartMerge(std::vector<RunCursor> *cursors, LoserTree *tree);
+
+  /** Moves a merge past its current head, the head of the cursor at the winner of the tree */
+  void AdvanceMerge(std::vector<RunCursor> *cursors, LoserTree *tree);
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The child if it is a gather, whose workers then collect and spill tuples in parallel */
+  GatherExecutor *gather_;
+  /** Encodes the keys of the tuples read back from runs */
+  SortKeyEncoder encoder_;
+  /** The number of runs merged at a time, bounded by the frames of the buffer pool */
+  size_t fan_in_{SORT_MERGE_FAN_IN};
+
+  /** One chunk per worker that produces input tuples */
+  std::vector<SortChunk> chunks_;
+  /** The tuples of all chunks in sort order, once the input is exhausted */
+  SortedEntries sorted_;
+  /** Protects runs_ while the workers add to it */
+  std::mutex runs_latch_;
+  /** The sorted runs written to temporary pages that have not been merged yet */
+  std::deque<std::unique_ptr<TmpTuplePartition>> runs_;
+
+  /** The runs of the merge that produces the output, and the tree that picks their next tuple */
+  std::vector<RunCursor> merge_;
+  LoserTree tree_;
 };
 }  // namespace bustub
@@ -12,19 +12,32 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/gather_executor.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
+#include "execution/sort_key.h"
+#include "execution/topn_cutoff.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * The executor keeps the best N input tuples seen so far in a max-heap on their normalized sort keys, so the worst of
+ * them is on top and a new tuple only has to beat it to get in, and sorts the N tuples once the input is exhausted.
+ * Below a gather, every worker fills a heap of its own, and the heaps are merged at the end.
+ *
+ * If the first ORDER BY expression is a column that passes unchanged through the projections and filters down to a
+ * sequential scan, the executor also hands a TopNCutoff to the scan, and tightens it to the first ORDER BY value of
+ * the top of the heap whenever that changes, so the scan skips the rows that cannot get into the heap.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -50,7 +63,55 @@ class TopNExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A tuple in a heap, with its normalized sort key */
+  struct TopNEntry {
+    /** Builds the tuple of a row of a batch in place, as a tuple is copied whenever it is moved */
+    TopNEntry(std::string &&key, const TupleBatch &batch, size_t row)
+        : key_{std::move(key)}, tuple_{batch.GetTuple(row)} {}
+
+    std::string key_;
+    Tuple tuple_;
+  };
+
+  /** The best N tuples one worker has seen */
+  struct TopNHeap {
+    explicit TopNHeap(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys)
+        : encoder_{order_bys} {}
+
+    SortKeyEncoder encoder_;
+    /** The keys of the current batch, reused between batches */
+    std::vector<std::string> keys_;
+    /** The tuples, in no particular order; a deque, so that tuples are never copied as it grows */
+    std::deque<TopNEntry> entries_;
+    /** Indexes into entries_, a max-heap by key, so the worst tuple is on top */
+    std::vector<size_t> heap_;
+  };
+
+  /** Offers the rows of a batch to a heap, and tightens the cutoff if the worst tuple of the heap changed */
+  void AddBatch(TopNHeap *heap, const TupleBatch &batch);
+
+  /**
+   * Finds the sequential scan whose rows the first ORDER BY expression reads unchanged.
+   * @param[out] column the index of the column in the schema of the table
+   * @return The scan plan node, or nullptr if there is none
+   */
+  auto FindCutoffScan(uint32_t *column) const -> const AbstractPlanNode *;
+
   /** The topn plan node to be executed */
   const TopNPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The child executor if it runs the pipeline below on several workers, nullptr otherwise */
+  GatherExecutor *gather_;
+  /** The cutoff handed to the scan below, or nullptr */
+  std::shared_ptr<TopNCutoff> cutoff_;
+
+  /** One heap per worker */
+  std::vector<TopNHeap> heaps_;
+  /** The best N tuples of all heaps, in order */
+  std::vector<const TopNEntry *> result_;
+  /** The next position of result_ Next produces */
+  size_t position_{0};
 };
+
 }  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.h
+//
+// Identification: src/include/execution/filter_kernels.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/** @return The number of 64-bit words of a selection bitmap over the given number of rows */
+inline auto BitmapWords(size_t rows) -> size_t { return (rows + 63) / 64; }
+
+/**
+ * Compares an array of column values with a constant, several values per instruction where the CPU has SIMD
+ * instructions for the type. Bit i of the bitmap is set if values[i] is not the null marker of the type and the
+ * comparison is true for it; the bits past the last value are cleared.
+ * @tparam T int32_t (INTEGER), int64_t (BIGINT) or double (DECIMAL)
+ * @param comparison the comparison, with the value on the left and the constant on the right
+ * @param values the column values in their storage representation
+ * @param rows the number of values
+ * @param constant the constant, which must not be null
+ * @param[out] bitmap BitmapWords(rows) words
+ */
+template <typename T>
+void CompareWithConstant(ComparisonType comparison, const T *values, size_t rows, T constant, uint64_t *bitmap);
+
+/**
+ * ColumnConstantFilter is a comparison of an INTEGER, BIGINT or DECIMAL column with a constant, which a scan can
+ * evaluate on its raw tuples with CompareWithConstant before it materializes any Value.
+ */
+class ColumnConstantFilter {
+ public:
+  /**
+   * Splits a predicate into a conjunction of column-constant comparisons and the rest.
+   * @param predicate the predicate over tuples of the schema
+   * @param schema the schema of the tuples
+   * @param[out] filters the comparisons that can be evaluated with the kernels
+   * @return The conjunction of the other terms of the predicate, or nullptr if there are none
+   */
+  static auto Split(const AbstractExpressionRef &predicate, const Schema &schema,
+                    std::vector<ColumnConstantFilter> *filters) -> AbstractExpressionRef;
+
+  /**
+   * Creates a comparison of a column with a constant.
+   * @param schema the schema of the tuples
+   * @param column the index of the column in the schema
+   * @param comparison the comparison, with the column on the left
+   * @param constant the constant
+   * @return The filter, or nullopt if the column type is not supported, the constant is null, or converting it to the
+   * type of the column could change the result
+   */
+  static auto Create(const Schema &schema, uint32_t column, ComparisonType comparison, const Value &constant)
+      -> std::optional<ColumnConstantFilter>;
+
+  /** Makes the comparison true for null values instead of false */
+  void SetNullsPass(bool nulls_pass) { nulls_pass_ = nulls_pass; }
+
+  /**
+   * Evaluates the comparison on some tuples, and clears the bits of the tuples it is not true for.
+   * @param tuples the tuples
+   * @param rows the number of tuples to evaluate, from the start of the vector
+   * @param[in,out] bitmap BitmapWords(rows) words
+   */
+  void Apply(const std::vector<Tuple> &tuples, size_t rows, uint64_t *bitmap);
+
+ private:
+  /** @return The filter for the expression if it is a supported comparison, nullopt otherwise */
+  static auto Match(const AbstractExpression &expr, const Schema &schema) -> std::optional<ColumnConstantFilter>;
+
+  /** Reads the column of some tuples into a typed buffer and runs the kernel on it */
+  template <typename T>
+  void ApplyTyped(const std::vector<Tuple> &tuples, size_t rows, std::vector<T> *buffer, T constant);
+
+  /** The type of the column */
+  TypeId type_{TypeId::INVALID};
+  /** The offset of the column in the tuple data */
+  uint32_t offset_{0};
+  /** The comparison, with the column on the left */
+  ComparisonType comparison_{ComparisonType::Equal};
+  /** Whether null values pass the comparison */
+  bool nulls_pass_{false};
+  /** The constant, converted to the type of the column */
+  int64_t int_constant_{0};
+  double decimal_constant_{0};
+
+  /** Buffers reused between calls to Apply */
+  std::vector<int32_t> int32_values_;
+  std::vector<int64_t> int64_values_;
+  std::vector<double> decimal_values_;
+  std::vector<uint64_t> result_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree picks the smallest head among k sorted inputs for a k-way merge. The inputs are the leaves of a binary
+ * tournament tree; every inner node remembers the loser of the match played there, and the overall winner is kept
+ * above the root. After the winner's input has advanced, only the matches on the path from its leaf to the root are
+ * replayed, which takes ceil(log2(k)) comparisons and no swaps of tuples.
+ *
+ * The tree only stores input numbers. The heads are compared through a callable less(a, b), which returns true if the
+ * head of input a comes before the head of input b; an exhausted input must come after every other one.
+ */
+class LoserTree {
+ public:
+  /**
+   * Plays all matches between the current heads of the inputs.
+   * @param inputs the number of inputs, at least one
+   * @param less the comparison of the heads of two inputs
+   */
+  template <typename Less>
+  void Init(size_t inputs, const Less &less) {
+    inputs_ = inputs;
+    // Every node starts with the pseudo-input `inputs`, which beats all others, so that the first input to reach a
+    // node wins there and carries on upwards until the leaves have all been played.
+    nodes_.assign(std::max<size_t>(inputs, 1), inputs);
+    for (size_t input = inputs; input-- > 0;) {
+      Play(input, less);
+    }
+  }
+
+  /** @return The input whose head comes first */
+  auto Winner() const -> size_t { return nodes_[0]; }
+
+  /** Replays the matches of the winner, after its input has advanced to its next head */
+  template <typename Less>
+  void Replay(const Less &less) {
+    Play(nodes_[0], less);
+  }
+
+ private:
+  template <typename Less>
+  void Play(size_t winner, const Less &less) {
+    for (size_t node = (winner + inputs_) / 2; node > 0; node /= 2) {
+      size_t &loser = nodes_[node];
+      if (loser == inputs_ || (winner != inputs_ && less(loser, winner))) {
+        std::swap(winner, loser);
+      }
+    }
+    nodes_[0] = winner;
+  }
+
+  size_t inputs_{0};
+  /** The winner at index 0, the loser of each inner node at the other indexes */
+  std::vector<size_t> nodes_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/morsel_queue.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * MorselQueue hands out the input of a parallel scan in small chunks ("morsels"). Every worker of the scan takes the
+ * next morsel as soon as it is done with the previous one, so workers that are faster, or that started earlier,
+ * simply process more morsels and no worker is left idle while another one still has a large share of the input.
+ *
+ * A morsel is a range of positions. For a table heap the positions index the pages of the table, for a mock table
+ * they are row numbers.
+ */
+class MorselQueue {
+ public:
+  /**
+   * Creates a queue over the positions [0, size).
+   * @param size the number of positions
+   * @param morsel_size the number of positions in a morsel
+   */
+  MorselQueue(size_t size, size_t morsel_size) : size_{size}, morsel_size_{morsel_size} {}
+
+  /**
+   * Creates a queue over the pages of a table.
+   * @param pages the pages of the table, in order
+   * @param morsel_size the number of pages in a morsel
+   */
+  MorselQueue(std::vector<page_id_t> pages, size_t morsel_size)
+      : pages_{std::move(pages)}, size_{pages_.size()}, morsel_size_{morsel_size} {}
+
+  DISALLOW_COPY_AND_MOVE(MorselQueue);
+
+  /**
+   * Takes the next morsel. Safe to call from several threads.
+   * @param[out] begin the first position of the morsel
+   * @param[out] end one past the last position of the morsel
+   * @return false if the input is exhausted
+   */
+  auto Next(size_t *begin, size_t *end) -> bool {
+    size_t first = next_.fetch_add(morsel_size_, std::memory_order_relaxed);
+    if (first >= size_) {
+      return false;
+    }
+    *begin = first;
+    *end = std::min(first + morsel_size_, size_);
+    return true;
+  }
+
+  /** @return The page at the given position of a queue over table pages */
+  auto GetPageId(size_t position) const -> page_id_t { return pages_[position]; }
+
+ private:
+  /** The pages of the table, empty for a queue over row numbers */
+  std::vector<page_id_t> pages_;
+  /** The number of positions */
+  size_t size_;
+  /** The number of positions in a morsel */
+  size_t morsel_size_;
+  /** The first position of the next morsel */
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pipeline.h
+//
+// Identification: src/include/execution/pipeline.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/** PipelineOperator is a step of a pipeline, which processes the batches pushed into it and emits its output. */
+class PipelineOperator {
+ public:
+  virtual ~PipelineOperator() = default;
+
+  /** Initializes the operator; init_below initializes the operators below it and the source */
+  virtual void Init(const std::function<void()> &init_below) { init_below(); }
+
+  /** Processes a batch, which the operator may modify or take over */
+  virtual void Push(TupleBatch *batch) = 0;
+
+  /** Emits the output the operator still holds, once all of its input has been pushed */
+  virtual void Finish() {}
+
+  /** Sets where the operator emits its output */
+  void SetEmit(std::function<void(TupleBatch *)> emit) { emit_ = std::move(emit); }
+
+ protected:
+  std::function<void(TupleBatch *)> emit_;
+};
+
+/**
+ * Pipeline runs the filters, projections and hash join probes at the top of a plan push-based. Its source, the
+ * executor of the first other node, produces batches in a tight loop, and every batch is pushed through the fused
+ * operators into a sink, instead of every operator pulling the batches of its child through NextBatch. The nodes below
+ * the source run as executors: pipeline breakers among them (aggregations, sorts, ...) materialize their input before
+ * the source produces anything, and so does the build side of every hash join of the pipeline.
+ *
+ * The execution engine runs the root of a query as a pipeline, and a GatherExecutor runs one pipeline per worker.
+ */
+class Pipeline {
+ public:
+  /**
+   * Compiles a plan into a pipeline.
+   * @param exec_ctx The executor context
+   * @param plan The root of the plan, whose output is the output of the pipeline
+   */
+  Pipeline(ExecutorContext *exec_ctx, AbstractPlanNodeRef plan);
+
+  ~Pipeline();
+
+  DISALLOW_COPY_AND_MOVE(Pipeline);
+
+  /**
+   * Adds an operator on top of the pipeline, which then outputs what the operator emits. Must be called before Init.
+   * @param op the operator, whose output schema is the one of the pipeline from then on
+   */
+  void AddOperator(std::unique_ptr<PipelineOperator> op);
+
+  /** Initializes the operators and the source, building the hash tables of the joins */
+  void Init();
+
+  /**
+   * Pushes the batches of the source through the operators until the source is exhausted or stop is set. Once the
+   * source is exhausted, the operators push the output they still hold.
+   * @param sink called with every batch the pipeline outputs, which it may modify
+   * @param stop checked before every batch of the source, or nullptr
+   */
+  void Run(const std::function<void(TupleBatch *)> &sink, const std::atomic<bool> *stop = nullptr);
+
+ private:
+  /** Pushes a batch into an operator, or into the sink past the last one */
+  void Emit(size_t op, TupleBatch *batch);
+
+  /** The root of the plan */
+  AbstractPlanNodeRef plan_;
+  /** The executor that produces the input of the pipeline */
+  std::unique_ptr<AbstractExecutor> source_;
+  /** The operators, from the one the source pushes into up to the root of the plan */
+  std::vector<std::unique_ptr<PipelineOperator>> operators_;
+  /** The sink of the current Run */
+  const std::function<void(TupleBatch *)> *sink_{nullptr};
+};
+
+}  // namespace bustub
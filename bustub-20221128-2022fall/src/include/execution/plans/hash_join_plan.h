@@ -23,7 +23,9 @@
 namespace bustub {
 
 /**
- * Hash join performs a JOIN operation with a hash table.
+ * Hash join performs a JOIN operation with a hash table. A radix-partitioned hash join partitions both of its inputs
+ * into partitions that fit in the CPU cache before it joins them, which the optimizer chooses when it expects the
+ * build side to be larger than the cache.
  */
 class HashJoinPlanNode : public AbstractPlanNode {
  public:
@@ -66,6 +68,9 @@ class HashJoinPlanNode : public AbstractPlanNode {
   /** @return The join type used in the hash join */
   auto GetJoinType() const -> JoinType { return join_type_; };
 
+  /** @return `true` if the join partitions both inputs into cache-sized partitions before joining them */
+  auto IsRadixPartitioned() const -> bool { return radix_partitioned_; }
+
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(HashJoinPlanNode);
 
   /** The expression to compute the left JOIN key */
@@ -76,10 +81,13 @@ class HashJoinPlanNode : public AbstractPlanNode {
   /** The join type */
   JoinType join_type_;
 
+  /** Whether the join partitions both inputs into cache-sized partitions before joining them */
+  bool radix_partitioned_{false};
+
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expression_,
-                       right_key_expression_);
+    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={}{} }}", join_type_, left_key_expression_,
+                       right_key_expression_, radix_partitioned_ ? ", radix_partitioned=true" : "");
   }
 };
 
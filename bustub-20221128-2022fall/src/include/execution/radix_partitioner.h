@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// radix_partitioner.h
+//
+// Identification: src/include/execution/radix_partitioner.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * RadixPartitioner scatters small entries, such as a hash and a pointer to a tuple, into partitions that end up one
+ * after the other in a single array, which is how a radix join lays out both of its inputs.
+ *
+ * A first pass counts the entries of every partition, so the second one knows where each partition starts and writes
+ * every entry straight to its final place. Entries are not written one by one though: every partition collects them in
+ * a write-combining buffer of one cache line, which is copied to the output as a whole once it is full. With many
+ * partitions, the buffers stay in cache while the output is written a full line at a time, instead of every entry
+ * touching a line of its own.
+ */
+template <typename Entry>
+class RadixPartitioner {
+  static_assert(std::is_trivially_copyable_v<Entry>, "entries are copied as raw memory");
+
+ public:
+  /** The size of a cache line, which is the size of a write-combining buffer */
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  /** The number of entries a write-combining buffer holds */
+  static constexpr size_t BUFFER_ENTRIES = std::max<size_t>(1, CACHE_LINE_SIZE / sizeof(Entry));
+
+  /**
+   * Scatters the entries into partitions.
+   * @param input the entries
+   * @param num_partitions the number of partitions
+   * @param partition_of returns the partition of an entry, smaller than num_partitions
+   * @param[out] output the entries, partition by partition, in the order of the input within a partition
+   * @param[out] offsets the position in output where every partition starts, followed by the number of entries
+   */
+  template <typename PartitionOf>
+  static void Scatter(const std::vector<Entry> &input, size_t num_partitions, const PartitionOf &partition_of,
+                      std::vector<Entry> *output, std::vector<size_t> *offsets) {
+    offsets->assign(num_partitions + 1, 0);
+    for (const auto &entry : input) {
+      (*offsets)[partition_of(entry) + 1]++;
+    }
+    for (size_t i = 0; i < num_partitions; i++) {
+      (*offsets)[i + 1] += (*offsets)[i];
+    }
+    output->resize(input.size());
+
+    std::vector<Buffer> buffers(num_partitions);
+    std::vector<size_t> buffered(num_partitions, 0);
+    std::vector<size_t> next(offsets->begin(), offsets->end() - 1);
+    for (const auto &entry : input) {
+      const auto partition = partition_of(entry);
+      auto &buffer = buffers[partition];
+      buffer.entries_[buffered[partition]++] = entry;
+      if (buffered[partition] == BUFFER_ENTRIES) {
+        std::copy(buffer.entries_, buffer.entries_ + BUFFER_ENTRIES, output->data() + next[partition]);
+        next[partition] += BUFFER_ENTRIES;
+        buffered[partition] = 0;
+      }
+    }
+    for (size_t partition = 0; partition < num_partitions; partition++) {
+      const auto &buffer = buffers[partition];
+      std::copy(buffer.entries_, buffer.entries_ + buffered[partition], output->data() + next[partition]);
+    }
+  }
+
+ private:
+  /** The write-combining buffer of a partition, which takes up one cache line */
+  struct alignas(CACHE_LINE_SIZE) Buffer {
+    Entry entries_[BUFFER_ENTRIES];  // NOLINT
+  };
+};
+
+}  // namespace bustub
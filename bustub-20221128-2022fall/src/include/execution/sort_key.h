@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * SortKeyEncoder turns the ORDER BY values of a tuple into a normalized key, a byte string that compares with memcmp
+ * the way the ORDER BY clause orders the tuples. Sorting on normalized keys costs one encoding per tuple, after which
+ * every comparison is a memcmp without any type dispatch or Value.
+ *
+ * Each value starts with a flag byte that sorts nulls before all other values. Integers follow in big-endian with the
+ * sign bit flipped, decimals as their IEEE bits, flipped so that negative numbers come first, and strings with every
+ * zero byte escaped and a two-byte terminator, so that a prefix sorts before the strings it starts. All bytes of a
+ * DESC value are inverted, which also puts its nulls last.
+ */
+class SortKeyEncoder {
+ public:
+  explicit SortKeyEncoder(std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys)
+      : order_bys_{std::move(order_bys)} {}
+
+  /**
+   * Encodes the key of a tuple.
+   * @param tuple the tuple
+   * @param schema the schema of the tuple
+   * @param[out] key the key, replacing the previous contents
+   */
+  void EncodeTuple(const Tuple &tuple, const Schema &schema, std::string *key) const;
+
+  /**
+   * Encodes the keys of the selected rows of a batch.
+   * @param batch the rows
+   * @param[out] keys the key of each selected row, in order
+   */
+  void EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys);
+
+  /** Appends the normalized form of a value to a key */
+  static void EncodeValue(const Value &value, bool descending, std::string *key);
+
+ private:
+  std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys_;
+  /** The values of one ORDER BY expression over a batch, reused between calls */
+  std::vector<Value> values_;
+};
+
+/** @return true if the tuple of key a sorts before the tuple of key b */
+inline auto SortKeyLess(const std::string &a, const std::string &b) -> bool {
+  int cmp = std::memcmp(a.data(), b.data(), std::min(a.size(), b.size()));
+  return cmp < 0 || (cmp == 0 && a.size() < b.size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_cutoff.h
+//
+// Identification: src/include/execution/topn_cutoff.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <optional>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/filter_kernels.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TopNCutoff carries the bound of a TopN executor down to the sequential scan below it. Once the heap of the TopN
+ * holds N tuples, a row can only get in if its first ORDER BY value does not come after the one of the last tuple of
+ * the heap, or comes strictly before it if there is only one ORDER BY expression. The TopN tightens the cutoff as its
+ * heap improves, and the scan evaluates it with a kernel on the raw tuples, so the rows that cannot make it are
+ * dropped before they are materialized, filtered, projected and sorted.
+ */
+class TopNCutoff {
+ public:
+  /**
+   * Creates a cutoff without a bound yet.
+   * @param column the index of the first ORDER BY column in the schema of the scanned table
+   * @param descending whether the column is sorted in descending order
+   * @param strict whether rows with a value equal to the bound can be dropped, as the column is the only ORDER BY key
+   */
+  TopNCutoff(uint32_t column, bool descending, bool strict)
+      : column_{column}, descending_{descending}, strict_{strict} {}
+
+  DISALLOW_COPY_AND_MOVE(TopNCutoff);
+
+  /**
+   * Tightens the bound to the first ORDER BY value of the last tuple of a full heap. A null bound, or one looser than
+   * the current bound, as another worker's heap may be ahead, is ignored.
+   */
+  void Update(const Value &bound) {
+    if (bound.IsNull()) {
+      return;
+    }
+    std::scoped_lock lock(latch_);
+    if (bound_.has_value()) {
+      const auto looser = descending_ ? bound.CompareLessThan(*bound_) : bound.CompareGreaterThan(*bound_);
+      if (looser != CmpBool::CmpFalse) {
+        return;
+      }
+    }
+    bound_ = bound;
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  /** @return The number of updates so far, to let scans check for a new bound without locking */
+  auto GetVersion() const -> uint64_t { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * @param schema the schema of the scanned table
+   * @return The filter that drops the rows beyond the current bound, or nullopt if there is no bound yet or the type
+   * of the column is not supported by the kernels
+   */
+  auto MakeFilter(const Schema &schema) -> std::optional<ColumnConstantFilter> {
+    std::scoped_lock lock(latch_);
+    if (!bound_.has_value()) {
+      return std::nullopt;
+    }
+    ComparisonType comparison;
+    if (descending_) {
+      comparison = strict_ ? ComparisonType::GreaterThan : ComparisonType::GreaterThanOrEqual;
+    } else {
+      comparison = strict_ ? ComparisonType::LessThan : ComparisonType::LessThanOrEqual;
+    }
+    auto filter = ColumnConstantFilter::Create(schema, column_, comparison, *bound_);
+    if (filter.has_value()) {
+      // Nulls come before all values in ascending order, and after them in descending order.
+      filter->SetNullsPass(!descending_);
+    }
+    return filter;
+  }
+
+ private:
+  uint32_t column_;
+  bool descending_;
+  bool strict_;
+  /** Protects bound_ */
+  std::mutex latch_;
+  std::optional<Value> bound_;
+  std::atomic<uint64_t> version_{0};
+};
+
+}  // namespace bustub
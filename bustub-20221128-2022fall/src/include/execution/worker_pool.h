@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.h
+//
+// Identification: src/include/execution/worker_pool.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * WorkerPool is a set of long-lived threads that run the parallel parts of queries. Tasks are run in the order they
+ * are submitted, by whichever thread is free first.
+ *
+ * A task must never wait for another task of the pool, otherwise the pool can deadlock once every thread is waiting.
+ */
+class WorkerPool {
+ public:
+  /**
+   * Creates a new WorkerPool and starts its threads.
+   * @param num_threads the number of threads of the pool
+   */
+  explicit WorkerPool(size_t num_threads);
+
+  /** Waits for the queued tasks and stops the threads. */
+  ~WorkerPool();
+
+  DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  /**
+   * Starts more threads so that the pool has at least the given number of them.
+   * @param num_threads the number of threads the pool should have
+   */
+  void Reserve(size_t num_threads);
+
+  /**
+   * Queues a task.
+   * @param task the task to run
+   * @return a future that becomes ready when the task has finished, holding the exception the task threw, if any
+   */
+  auto Submit(std::function<void()> task) -> std::future<void>;
+
+  /**
+   * Runs task(0) to task(count - 1) on the pool and waits for all of them, then rethrows the first exception a task
+   * threw, if any. Must not be called from a task of the pool.
+   * @param count the number of tasks
+   * @param task the task, called with its number
+   */
+  void ParallelFor(size_t count, const std::function<void(size_t)> &task);
+
+ private:
+  /** Runs tasks until the pool is destroyed */
+  void WorkerLoop();
+
+  /** Protects tasks_ and shutdown_ */
+  std::mutex latch_;
+  /** Signaled when a task is queued or the pool shuts down */
+  std::condition_variable cv_;
+  /** Tasks that have not been picked up by a thread yet */
+  std::deque<std::packaged_task<void()>> tasks_;
+  /** The threads of the pool */
+  std::vector<std::thread> threads_;
+  /** Set when the pool is being destroyed */
+  bool shutdown_{false};
+};
+
+}  // namespace bustub
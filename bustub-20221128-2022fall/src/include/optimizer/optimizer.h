@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -8,6 +9,7 @@
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/config.h"
 #include "concurrency/transaction.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
@@ -21,8 +23,9 @@ namespace bustub {
  */
 class Optimizer {
  public:
-  explicit Optimizer(const Catalog &catalog, bool force_starter_rule)
-      : catalog_(catalog), force_starter_rule_(force_starter_rule) {}
+  explicit Optimizer(const Catalog &catalog, bool force_starter_rule,
+                     size_t radix_join_build_rows = RADIX_JOIN_BUILD_ROWS)
+      : catalog_(catalog), force_starter_rule_(force_starter_rule), radix_join_build_rows_(radix_join_build_rows) {}
 
   auto Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -50,6 +53,24 @@ class Optimizer {
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize hash join into merge join if both of its inputs are already sorted on their join keys, e.g. by a
+   * sort in a subquery or by an index scan.
+   */
+  auto OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief make hash joins radix-partitioned if their build side is expected to be too large for the CPU cache, so
+   * that they join one cache-sized partition of both inputs at a time.
+   */
+  auto OptimizeHashJoinAsRadixJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief get the estimated number of tuples a plan produces, if the tables it reads have an estimate */
+  auto EstimatedPlanCardinality(const AbstractPlanNode &plan) -> std::optional<size_t>;
+
+  /** @brief check if a plan produces its tuples in ascending order of a column, nulls first */
+  auto IsSortedOn(const AbstractPlanNode &plan, uint32_t column) -> bool;
+
   /**
    * @brief optimize nested loop join into index join.
    */
@@ -109,6 +130,9 @@ class Optimizer {
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  /** The estimated build tuples from which a hash join is radix-partitioned */
+  const size_t radix_join_build_rows_;
 };
 
 }  // namespace bustub
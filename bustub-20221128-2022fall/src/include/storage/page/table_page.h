@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -123,6 +124,14 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Read all tuples of the page without copying them one by one: the page is copied into a buffer, and the tuples
+   * point at their data in the copy.
+   * @param copy a buffer of BUSTUB_PAGE_SIZE bytes, which must outlive the tuples
+   * @param[out] tuples the tuples that are not deleted are appended to it
+   */
+  void GetTupleViews(char *copy, std::vector<Tuple> *tuples);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -22,15 +22,59 @@ class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /** @return The offset of the most recently inserted tuple, or the page size if the page is empty */
+  auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /**
+   * Appends a tuple to the page.
+   * @param tuple the tuple to insert
+   * @param[out] out the location of the inserted tuple
+   * @return false if the page does not have enough free space left
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    uint32_t free_space = GetFreeSpacePointer();
+    uint32_t tuple_size = sizeof(uint32_t) + tuple.GetLength();
+    if (free_space < SIZE_TMP_TUPLE_PAGE_HEADER + tuple_size) {
+      return false;
+    }
+    free_space -= tuple_size;
+    tuple.SerializeTo(GetData() + free_space);
+    SetFreeSpacePointer(free_space);
+    *out = TmpTuple(GetTablePageId(), free_space);
+    return true;
+  }
+
+  /**
+   * Reads a tuple back from the page.
+   * @param tmp_tuple the location returned by Insert
+   * @param[out] tuple the tuple stored at that location
+   * @return the offset of the tuple that was inserted before this one, or the page size if there is none
+   */
+  auto Get(const TmpTuple &tmp_tuple, Tuple *tuple) -> uint32_t {
+    tuple->DeserializeFrom(GetData() + tmp_tuple.GetOffset());
+    return tmp_tuple.GetOffset() + sizeof(uint32_t) + tuple->GetLength();
+  }
+
+  /** @return the offset of the tuple that was inserted before the one at the given offset, or the page size */
+  auto GetPreviousOffset(uint32_t offset) -> uint32_t {
+    return offset + sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_FREE_SPACE = sizeof(page_id_t) + sizeof(lsn_t);
+  static constexpr size_t SIZE_TMP_TUPLE_PAGE_HEADER = OFFSET_FREE_SPACE + sizeof(uint32_t);
+
+  void SetFreeSpacePointer(uint32_t free_space) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -105,6 +107,17 @@ class TableHeap {
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
 
+  /** @return the ids of all pages of this table, in order */
+  auto GetPageIds() -> std::vector<page_id_t>;
+
+  /**
+   * Read all tuples of one page of the table without copying them one by one, see TablePage::GetTupleViews.
+   * @param page_id the page to read
+   * @param copy a buffer of BUSTUB_PAGE_SIZE bytes the page is copied into, which must outlive the tuples
+   * @param[out] tuples the tuples of the page are appended to it
+   */
+  void GetPageTupleViews(page_id_t page_id, char *copy, std::vector<Tuple> *tuples);
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_partition.h
+//
+// Identification: src/include/storage/table/tmp_tuple_partition.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * TmpTuplePartition is a sequence of tuples spilled by an executor to temporary pages in the buffer pool.
+ * Tuples are appended, then read back once; every page is deleted as soon as it has been read, and whatever is left
+ * is deleted when the partition is destroyed. At most one page of the partition is pinned at a time.
+ */
+class TmpTuplePartition {
+ public:
+  explicit TmpTuplePartition(BufferPoolManager *bpm) : bpm_{bpm} {}
+
+  ~TmpTuplePartition();
+
+  DISALLOW_COPY_AND_MOVE(TmpTuplePartition);
+
+  /** Appends a tuple. Throws if the buffer pool has no free frame. */
+  void Append(const Tuple &tuple);
+
+  /** Unpins the page tuples are appended to. Must be called before reading the partition. */
+  void FinishAppend();
+
+  /**
+   * Moves the tuples of another partition behind the ones of this partition, without copying them. FinishAppend must
+   * have been called on both partitions, and neither may have been read from.
+   * @param other the partition to take the tuples of, which is empty afterwards
+   */
+  void Absorb(TmpTuplePartition *other);
+
+  /**
+   * Reads the next tuple. Tuples come back in the order they were appended.
+   * @param[out] tuple the tuple read
+   * @return false if all tuples have been read
+   */
+  auto Next(Tuple *tuple) -> bool;
+
+  /**
+   * Reads tuples until the batch is full.
+   * @param schema the schema of the tuples
+   * @param[out] batch the tuples read
+   * @return false if all tuples have been read
+   */
+  auto NextBatch(const Schema *schema, TupleBatch *batch) -> bool;
+
+  /** @return The number of tuples appended to the partition */
+  auto Size() const -> size_t { return num_tuples_; }
+
+  /** @return The number of bytes the appended tuples take on their pages */
+  auto DataSize() const -> size_t { return data_size_; }
+
+ private:
+  BufferPoolManager *bpm_;
+  /** The pages of the partition that have not been read yet */
+  std::vector<page_id_t> pages_{};
+  /** The page being appended to or read from, pinned */
+  TmpTuplePage *current_page_{nullptr};
+  /** Index in pages_ of the page being read */
+  size_t read_index_{0};
+  /** Offsets of the tuples of the current page that have not been read yet, the next one last */
+  std::vector<uint32_t> read_offsets_{};
+  size_t num_tuples_{0};
+  size_t data_size_{0};
+};
+
+}  // namespace bustub
@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/arena.h"
 #include "common/rid.h"
 #include "type/value.h"
 
@@ -42,12 +44,54 @@ class Tuple {
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
+  // Creates a tuple from the values of its columns, where value_of(i) returns the value of column i. If an arena is
+  // given, the tuple's data is allocated from it and not owned by the tuple, and stays valid until the arena is reset.
+  template <typename ValueOf>
+  static auto FromValues(const Schema *schema, const ValueOf &value_of, Arena *arena = nullptr) -> Tuple {
+    // 1. Calculate the size of the tuple.
+    uint32_t tuple_size = schema->GetLength();
+    for (auto i : schema->GetUnlinedColumns()) {
+      auto len = value_of(i).GetLength();
+      tuple_size += (len == BUSTUB_VALUE_NULL ? 0 : len) + sizeof(uint32_t);
+    }
+
+    // 2. Allocate memory.
+    Tuple tuple;
+    tuple.allocated_ = arena == nullptr;
+    tuple.size_ = tuple_size;
+    tuple.data_ = arena == nullptr ? new char[tuple_size] : arena->Allocate(tuple_size);
+    std::memset(tuple.data_, 0, tuple_size);
+
+    // 3. Serialize each attribute based on the input value.
+    uint32_t offset = schema->GetLength();
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const auto &col = schema->GetColumn(i);
+      const Value &value = value_of(i);
+      if (!col.IsInlined()) {
+        // Serialize relative offset, where the actual varchar data is stored, and the value in place (size+data).
+        *reinterpret_cast<uint32_t *>(tuple.data_ + col.GetOffset()) = offset;
+        value.SerializeTo(tuple.data_ + offset);
+        auto len = value.GetLength();
+        offset += (len == BUSTUB_VALUE_NULL ? 0 : len) + sizeof(uint32_t);
+      } else {
+        value.SerializeTo(tuple.data_ + col.GetOffset());
+      }
+    }
+    return tuple;
+  }
+
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move constructor, takes over the data of the other tuple, which is left empty
+  Tuple(Tuple &&other) noexcept;
+
+  // move assign operator, takes over the data of the other tuple, which is left empty
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -82,7 +126,12 @@ class Tuple {
     Value value = GetValue(schema, column_idx);
     return value.IsNull();
   }
-  inline auto IsAllocated() -> bool { return allocated_; }
+  // Makes the tuple own its data, copying it if the tuple points into data it does not own
+  void Materialize();
+
+  // Does the tuple own its data? Tuples read with TableHeap::GetPageTupleViews point into a copy of their page, those
+  // created in an arena point into the arena, and copies of them point to the same data.
+  inline auto IsAllocated() const -> bool { return allocated_; }
 
   auto ToString(const Schema *schema) const -> std::string;
 
@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/storage/table/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to about TUPLE_BATCH_SIZE rows in column-oriented form, one vector of values per column of its
+ * schema. A selection vector can narrow the batch down to some of its rows without moving any value, which is how a
+ * filter passes a batch on. Unless noted otherwise, row indexes are positions among the selected rows.
+ */
+class TupleBatch {
+ public:
+  TupleBatch() = default;
+
+  /** Empties the batch and makes it hold rows of the given schema. */
+  void Reset(const Schema *schema) {
+    schema_ = schema;
+    columns_.resize(schema->GetColumnCount());
+    for (auto &column : columns_) {
+      column.clear();
+    }
+    num_rows_ = 0;
+    selection_.clear();
+    has_selection_ = false;
+  }
+
+  /** @return The schema of the rows */
+  auto GetSchema() const -> const Schema * { return schema_; }
+
+  /** @return The number of selected rows */
+  auto Size() const -> size_t { return has_selection_ ? selection_.size() : num_rows_; }
+
+  /** @return `true` if rows should not be appended anymore */
+  auto IsFull() const -> bool { return num_rows_ >= TUPLE_BATCH_SIZE; }
+
+  /** @return The position in the column vectors of the i-th selected row */
+  auto RowAt(size_t i) const -> uint32_t { return has_selection_ ? selection_[i] : i; }
+
+  /** @return The value of a column in the i-th selected row */
+  auto GetValue(size_t i, uint32_t column) const -> const Value & { return columns_[column][RowAt(i)]; }
+
+  /**
+   * @return The i-th selected row as a tuple
+   * @param arena where the tuple's data is allocated from, or `nullptr` to make the tuple own its data
+   */
+  auto GetTuple(size_t i, Arena *arena = nullptr) const -> Tuple {
+    const auto row = RowAt(i);
+    return Tuple::FromValues(
+        schema_, [this, row](uint32_t column) -> const Value & { return columns_[column][row]; }, arena);
+  }
+
+  /** Appends a row holding the values of a tuple of the batch's schema. The batch must not have a selection. */
+  void AppendTuple(const Tuple &tuple) {
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+      columns_[i].push_back(tuple.GetValue(schema_, i));
+    }
+    num_rows_++;
+  }
+
+  /** Appends a row from its values in column order. The batch must not have a selection. */
+  void AppendRow(const std::vector<Value> &values) {
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+      columns_[i].push_back(values[i]);
+    }
+    num_rows_++;
+  }
+
+  /** Appends a row from its values in column order, moving them into the batch. */
+  void AppendRow(std::vector<Value> &&values) {
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+      columns_[i].push_back(std::move(values[i]));
+    }
+    num_rows_++;
+  }
+
+  /** Replaces all values of a column, and sets the number of rows to the number of values. */
+  void SetColumn(uint32_t column, std::vector<Value> &&values) {
+    num_rows_ = values.size();
+    columns_[column] = std::move(values);
+  }
+
+  /**
+   * Narrows the batch down to some of its rows.
+   * @param selection positions in the column vectors of the rows to keep, as returned by RowAt, in increasing order
+   */
+  void SetSelection(std::vector<uint32_t> &&selection) {
+    selection_ = std::move(selection);
+    has_selection_ = true;
+  }
+
+ private:
+  const Schema *schema_{nullptr};
+  /** The values of each column, including the rows that are not selected */
+  std::vector<std::vector<Value>> columns_{};
+  size_t num_rows_{0};
+  std::vector<uint32_t> selection_{};
+  bool has_selection_{false};
+};
+
+}  // namespace bustub
@@ -64,6 +64,8 @@ class Value {
 
   Value() : Value(TypeId::INVALID) {}
   Value(const Value &other);
+  // takes over the data of the other value, which is left invalid
+  Value(Value &&other) noexcept : Value() { Swap(*this, other); }
   auto operator=(Value other) -> Value &;
   ~Value();
   // NOLINTNEXTLINE
@@ -145,6 +147,14 @@ class Value {
   inline auto Copy() const -> Value { return Type::GetInstance(type_id_)->Copy(*this); }
 
  protected:
+  // Does the value keep its VARCHAR data in value_? The data a value manages is kept there if it fits, so that short
+  // strings are created and copied without an allocation.
+  inline auto IsVarlenInlined() const -> bool { return manage_data_ && size_.len_ <= sizeof(Val); }
+  // The VARCHAR data, wherever it is kept
+  inline auto GetVarlen() const -> const char * {
+    return IsVarlenInlined() ? value_.inline_varlen_ : value_.const_varlen_;
+  }
+
   // The actual value item
   union Val {
     int8_t boolean_;
@@ -156,6 +166,8 @@ class Value {
     uint64_t timestamp_;
     char *varlen_;
     const char *const_varlen_;
+    // VARCHAR data short enough to be kept in the value itself
+    char inline_varlen_[sizeof(uint64_t)];
   } value_;
 
   union {
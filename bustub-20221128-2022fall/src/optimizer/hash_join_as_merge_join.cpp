@@ -0,0 +1,78 @@
+#include <memory>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::IsSortedOn(const AbstractPlanNode &plan, uint32_t column) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::Sort:
+    case PlanType::TopN: {
+      const auto &order_bys = plan.GetType() == PlanType::Sort ? dynamic_cast<const SortPlanNode &>(plan).GetOrderBy()
+                                                               : dynamic_cast<const TopNPlanNode &>(plan).GetOrderBy();
+      const auto &[order_type, expr] = order_bys[0];
+      const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      return (order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT) && column_value_expr != nullptr &&
+             column_value_expr->GetColIdx() == column;
+    }
+    case PlanType::IndexScan: {
+      // An index scan produces the tuples of the table in the order of the key of its index.
+      const auto *index_info = catalog_.GetIndex(dynamic_cast<const IndexScanPlanNode &>(plan).GetIndexOid());
+      const auto *table_info = catalog_.GetTable(index_info->table_name_);
+      const auto &key_columns = index_info->key_schema_.GetColumns();
+      return key_columns.size() == 1 && key_columns[0].GetName() == table_info->schema_.GetColumn(column).GetName();
+    }
+    case PlanType::Projection: {
+      const auto &expr = dynamic_cast<const ProjectionPlanNode &>(plan).GetExpressions()[column];
+      const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      return column_value_expr != nullptr && IsSortedOn(*plan.GetChildAt(0), column_value_expr->GetColIdx());
+    }
+    case PlanType::Filter:
+      return IsSortedOn(*plan.GetChildAt(0), column);
+    case PlanType::MergeJoin: {
+      // A merge join produces its left input in order, with the matches of each tuple next to it.
+      const auto &merge_join_plan = dynamic_cast<const MergeJoinPlanNode &>(plan);
+      const auto *left_key = dynamic_cast<const ColumnValueExpression *>(&merge_join_plan.LeftJoinKeyExpression());
+      return column < merge_join_plan.GetLeftPlan()->OutputSchema().GetColumnCount() && left_key != nullptr &&
+             (left_key->GetColIdx() == column || IsSortedOn(*merge_join_plan.GetLeftPlan(), column));
+    }
+    default:
+      return false;
+  }
+}
+
+auto Optimizer::OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinAsMergeJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::HashJoin) {
+    const auto &hash_join_plan = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+    const auto *left_key = dynamic_cast<const ColumnValueExpression *>(&hash_join_plan.LeftJoinKeyExpression());
+    const auto *right_key = dynamic_cast<const ColumnValueExpression *>(&hash_join_plan.RightJoinKeyExpression());
+    // Both inputs are already sorted on their keys, so there is no need to build a hash table.
+    if (left_key != nullptr && right_key != nullptr &&
+        IsSortedOn(*hash_join_plan.GetLeftPlan(), left_key->GetColIdx()) &&
+        IsSortedOn(*hash_join_plan.GetRightPlan(), right_key->GetColIdx())) {
+      return std::make_shared<MergeJoinPlanNode>(hash_join_plan.output_schema_, hash_join_plan.GetLeftPlan(),
+                                                 hash_join_plan.GetRightPlan(), hash_join_plan.left_key_expression_,
+                                                 hash_join_plan.right_key_expression_, hash_join_plan.GetJoinType());
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
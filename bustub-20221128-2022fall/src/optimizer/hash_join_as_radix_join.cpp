@@ -0,0 +1,49 @@
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::EstimatedPlanCardinality(const AbstractPlanNode &plan) -> std::optional<size_t> {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+      return EstimatedCardinality(dynamic_cast<const SeqScanPlanNode &>(plan).table_name_);
+    case PlanType::MockScan:
+      return EstimatedCardinality(dynamic_cast<const MockScanPlanNode &>(plan).GetTable());
+    // Without statistics, the input is the best guess for the output as well.
+    case PlanType::Filter:
+    case PlanType::Projection:
+    case PlanType::Sort:
+      return EstimatedPlanCardinality(*plan.GetChildAt(0));
+    default:
+      return std::nullopt;
+  }
+}
+
+auto Optimizer::OptimizeHashJoinAsRadixJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinAsRadixJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::HashJoin) {
+    const auto &hash_join_plan = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+    // A build side that does not fit in the cache makes every probe of a single hash table miss in it.
+    auto build_cardinality = EstimatedPlanCardinality(*hash_join_plan.GetRightPlan());
+    if (build_cardinality.has_value() && *build_cardinality >= radix_join_build_rows_) {
+      auto radix_join = std::make_shared<HashJoinPlanNode>(hash_join_plan);
+      radix_join->radix_partitioned_ = true;
+      return radix_join;
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 #include "catalog/column.h"
 #include "catalog/schema.h"
 #include "common/exception.h"
@@ -7,6 +9,7 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/hash_join_plan.h"
@@ -14,9 +17,125 @@
 #include "execution/plans/projection_plan.h"
 #include "optimizer/optimizer.h"
 #include "type/type_id.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+/** Appends the terms of a conjunction, or the expression itself if it is not one */
+static void SplitConjunction(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *terms) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    SplitConjunction(logic->GetChildAt(0), terms);
+    SplitConjunction(logic->GetChildAt(1), terms);
+    return;
+  }
+  terms->push_back(expr);
+}
+
+/** @return The conjunction of the terms, or nullptr if there are none */
+static auto MakeConjunction(const std::vector<AbstractExpressionRef> &terms) -> AbstractExpressionRef {
+  AbstractExpressionRef conjunction;
+  for (const auto &term : terms) {
+    conjunction = conjunction == nullptr ? term : std::make_shared<LogicExpression>(conjunction, term, LogicType::And);
+  }
+  return conjunction;
+}
+
+/** @return The sides of a join an expression reads, bit 0 for the left one and bit 1 for the right one */
+static auto JoinSides(const AbstractExpression &expr) -> uint32_t {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(&expr); column != nullptr) {
+    return 1U << column->GetTupleIdx();
+  }
+  uint32_t sides = 0;
+  for (const auto &child : expr.GetChildren()) {
+    sides |= JoinSides(*child);
+  }
+  return sides;
+}
+
+/**
+ * Rewrites an expression over the two sides of a join into one over a single tuple: the columns of the left side keep
+ * their index, and those of the right side are shifted by right_offset.
+ */
+static auto RewriteAsSingleTuple(const AbstractExpressionRef &expr, uint32_t right_offset) -> AbstractExpressionRef {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    return std::make_shared<ColumnValueExpression>(
+        0, column->GetColIdx() + (column->GetTupleIdx() == 1 ? right_offset : 0), column->GetReturnType());
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(RewriteAsSingleTuple(child, right_offset));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+/**
+ * Splits the predicate of an inner join into the terms that read a single side, which are pushed below the join as
+ * filters, an equality of a left column and a right column to hash on, and the rest, which is evaluated on the output
+ * of the join.
+ * @return The rewritten join, or nullptr if nothing could be pushed down or hashed on
+ */
+static auto SplitInnerJoinPredicate(const NestedLoopJoinPlanNode &nlj_plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractExpressionRef> terms;
+  SplitConjunction(nlj_plan.predicate_, &terms);
+  std::vector<AbstractExpressionRef> left_terms;
+  std::vector<AbstractExpressionRef> right_terms;
+  std::vector<AbstractExpressionRef> join_terms;
+  AbstractExpressionRef left_key;
+  AbstractExpressionRef right_key;
+  for (const auto &term : terms) {
+    const auto sides = JoinSides(*term);
+    if (sides == 1) {
+      left_terms.push_back(RewriteAsSingleTuple(term, 0));
+      continue;
+    }
+    if (sides == 2) {
+      right_terms.push_back(RewriteAsSingleTuple(term, 0));
+      continue;
+    }
+    if (const auto *expr = dynamic_cast<const ComparisonExpression *>(term.get());
+        left_key == nullptr && expr != nullptr && expr->comp_type_ == ComparisonType::Equal) {
+      const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+      const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+      if (left_expr != nullptr && right_expr != nullptr && left_expr->GetTupleIdx() != right_expr->GetTupleIdx()) {
+        if (left_expr->GetTupleIdx() == 1) {
+          std::swap(left_expr, right_expr);
+        }
+        left_key = std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType());
+        right_key = std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType());
+        continue;
+      }
+    }
+    join_terms.push_back(term);
+  }
+  if (left_terms.empty() && right_terms.empty() && left_key == nullptr) {
+    return nullptr;
+  }
+
+  auto push_down = [](const AbstractPlanNodeRef &child, const std::vector<AbstractExpressionRef> &terms) {
+    return terms.empty() ? child
+                         : std::make_shared<FilterPlanNode>(child->output_schema_, MakeConjunction(terms), child);
+  };
+  auto left = push_down(nlj_plan.GetLeftPlan(), left_terms);
+  auto right = push_down(nlj_plan.GetRightPlan(), right_terms);
+  if (left_key == nullptr) {
+    auto predicate = join_terms.empty() ? std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(true))
+                                        : MakeConjunction(join_terms);
+    return std::make_shared<NestedLoopJoinPlanNode>(nlj_plan.output_schema_, std::move(left), std::move(right),
+                                                    std::move(predicate), nlj_plan.GetJoinType());
+  }
+  AbstractPlanNodeRef hash_join = std::make_shared<HashJoinPlanNode>(
+      nlj_plan.output_schema_, std::move(left), std::move(right), std::move(left_key), std::move(right_key),
+      nlj_plan.GetJoinType());
+  if (join_terms.empty()) {
+    return hash_join;
+  }
+  const auto left_column_cnt = nlj_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+  return std::make_shared<FilterPlanNode>(nlj_plan.output_schema_,
+                                          RewriteAsSingleTuple(MakeConjunction(join_terms), left_column_cnt),
+                                          std::move(hash_join));
+}
+
 auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   std::vector<AbstractPlanNodeRef> children;
   for (const auto &child : plan->GetChildren()) {
@@ -29,6 +148,13 @@ auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> Abstra
     // Has exactly two children
     BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
 
+    // The terms of the predicate of an inner join can be evaluated anywhere, so they are split up.
+    if (nlj_plan.GetJoinType() == JoinType::INNER) {
+      if (auto split_plan = SplitInnerJoinPredicate(nlj_plan); split_plan != nullptr) {
+        return split_plan;
+      }
+    }
+
     // Check if expr is equal condition where one is for the left table, and one is for the right table.
     if (const auto *expr = dynamic_cast<const ComparisonExpression *>(&nlj_plan.Predicate()); expr != nullptr) {
       if (expr->comp_type_ == ComparisonType::Equal) {
@@ -12,9 +12,15 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
   p = OptimizeNLJAsIndexJoin(p);
-  // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
+  p = OptimizeNLJAsHashJoin(p);
   p = OptimizeOrderByAsIndexScan(p);
+  // Runs after the index scans are in place, as they provide the sort order.
+  p = OptimizeHashJoinAsMergeJoin(p);
+  // Runs after the merge joins are in place, so it only looks at the hash joins that are left.
+  p = OptimizeHashJoinAsRadixJoin(p);
   p = OptimizeSortLimitAsTopN(p);
+  // Runs last, as the rules above only look for scans without a predicate.
+  p = OptimizeMergeFilterScan(p);
   return p;
 }
 
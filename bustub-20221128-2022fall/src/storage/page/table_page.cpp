@@ -326,6 +326,19 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
+void TablePage::GetTupleViews(char *copy, std::vector<Tuple> *tuples) {
+  memcpy(copy, GetData(), BUSTUB_PAGE_SIZE);
+  for (uint32_t slot_num = 0; slot_num < GetTupleCount(); slot_num++) {
+    uint32_t tuple_size = GetTupleSize(slot_num);
+    if (IsDeleted(tuple_size)) {
+      continue;
+    }
+    auto &tuple = tuples->emplace_back(RID(GetTablePageId(), slot_num));
+    tuple.size_ = tuple_size;
+    tuple.data_ = copy + GetTupleOffsetAtSlot(slot_num);
+  }
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
@@ -196,6 +196,30 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   return {this, rid, txn};
 }
 
+auto TableHeap::GetPageIds() -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(page_id);
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return page_ids;
+}
+
+void TableHeap::GetPageTupleViews(page_id_t page_id, char *copy, std::vector<Tuple> *tuples) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  page->RLatch();
+  page->GetTupleViews(copy, tuples);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
 }  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_partition.cpp
+//
+// Identification: src/storage/table/tmp_tuple_partition.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_partition.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTuplePartition::~TmpTuplePartition() {
+  if (current_page_ != nullptr) {
+    bpm_->UnpinPage(current_page_->GetPageId(), false);
+  }
+  for (size_t i = read_index_; i < pages_.size(); i++) {
+    bpm_->DeletePage(pages_[i]);
+  }
+}
+
+void TmpTuplePartition::Append(const Tuple &tuple) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (current_page_ == nullptr || !current_page_->Insert(tuple, &tmp_tuple)) {
+    if (current_page_ != nullptr) {
+      bpm_->UnpinPage(current_page_->GetPageId(), true);
+    }
+    page_id_t page_id;
+    current_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+    if (current_page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to spill tuples to");
+    }
+    pages_.push_back(page_id);
+    current_page_->Init(page_id, BUSTUB_PAGE_SIZE);
+    if (!current_page_->Insert(tuple, &tmp_tuple)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "tuple is too large to spill");
+    }
+  }
+  num_tuples_++;
+  data_size_ += sizeof(uint32_t) + tuple.GetLength();
+}
+
+void TmpTuplePartition::FinishAppend() {
+  if (current_page_ != nullptr) {
+    bpm_->UnpinPage(current_page_->GetPageId(), true);
+    current_page_ = nullptr;
+  }
+}
+
+void TmpTuplePartition::Absorb(TmpTuplePartition *other) {
+  BUSTUB_ASSERT(current_page_ == nullptr && other->current_page_ == nullptr, "partitions must not be pinned");
+  BUSTUB_ASSERT(read_index_ == 0 && other->read_index_ == 0, "partitions must not have been read");
+  pages_.insert(pages_.end(), other->pages_.begin(), other->pages_.end());
+  num_tuples_ += other->num_tuples_;
+  data_size_ += other->data_size_;
+  other->pages_.clear();
+  other->num_tuples_ = 0;
+  other->data_size_ = 0;
+}
+
+auto TmpTuplePartition::Next(Tuple *tuple) -> bool {
+  while (read_offsets_.empty()) {
+    if (current_page_ != nullptr) {
+      bpm_->UnpinPage(pages_[read_index_], false);
+      bpm_->DeletePage(pages_[read_index_]);
+      current_page_ = nullptr;
+      read_index_++;
+    }
+    if (read_index_ == pages_.size()) {
+      return false;
+    }
+    current_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(pages_[read_index_]));
+    if (current_page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to read spilled tuples");
+    }
+    // The page holds its tuples newest first, so the offset of the oldest one ends up at the back.
+    for (uint32_t offset = current_page_->GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE;
+         offset = current_page_->GetPreviousOffset(offset)) {
+      read_offsets_.push_back(offset);
+    }
+  }
+  current_page_->Get(TmpTuple(pages_[read_index_], read_offsets_.back()), tuple);
+  read_offsets_.pop_back();
+  return true;
+}
+
+auto TmpTuplePartition::NextBatch(const Schema *schema, TupleBatch *batch) -> bool {
+  batch->Reset(schema);
+  Tuple tuple{};
+  while (!batch->IsFull() && Next(&tuple)) {
+    batch->AppendTuple(tuple);
+  }
+  return batch->Size() != 0;
+}
+
+}  // namespace bustub
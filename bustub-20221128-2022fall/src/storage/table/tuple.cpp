@@ -21,44 +21,9 @@
 namespace bustub {
 
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
+Tuple::Tuple(std::vector<Value> values, const Schema *schema)
+    : Tuple(FromValues(schema, [&values](uint32_t i) -> const Value & { return values[i]; })) {
   assert(values.size() == schema->GetColumnCount());
-
-  // 1. Calculate the size of the tuple.
-  uint32_t tuple_size = schema->GetLength();
-  for (auto &i : schema->GetUnlinedColumns()) {
-    auto len = values[i].GetLength();
-    if (len == BUSTUB_VALUE_NULL) {
-      len = 0;
-    }
-    tuple_size += (len + sizeof(uint32_t));
-  }
-
-  // 2. Allocate memory.
-  size_ = tuple_size;
-  data_ = new char[size_];
-  std::memset(data_, 0, size_);
-
-  // 3. Serialize each attribute based on the input value.
-  uint32_t column_count = schema->GetColumnCount();
-  uint32_t offset = schema->GetLength();
-
-  for (uint32_t i = 0; i < column_count; i++) {
-    const auto &col = schema->GetColumn(i);
-    if (!col.IsInlined()) {
-      // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_ + col.GetOffset()) = offset;
-      // Serialize varchar value, in place (size+data).
-      values[i].SerializeTo(data_ + offset);
-      auto len = values[i].GetLength();
-      if (len == BUSTUB_VALUE_NULL) {
-        len = 0;
-      }
-      offset += (len + sizeof(uint32_t));
-    } else {
-      values[i].SerializeTo(data_ + col.GetOffset());
-    }
-  }
 }
 
 Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
@@ -95,6 +60,40 @@ auto Tuple::operator=(const Tuple &other) -> Tuple & {
   return *this;
 }
 
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), data_(other.data_) {
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+}
+
+auto Tuple::operator=(Tuple &&other) noexcept -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
+  if (allocated_) {
+    delete[] data_;
+  }
+  allocated_ = other.allocated_;
+  rid_ = other.rid_;
+  size_ = other.size_;
+  data_ = other.data_;
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+  return *this;
+}
+
+void Tuple::Materialize() {
+  if (allocated_ || data_ == nullptr) {
+    return;
+  }
+  auto *data = new char[size_];
+  memcpy(data, data_, size_);
+  data_ = data;
+  allocated_ = true;
+}
+
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
   assert(schema);
   assert(data_);
@@ -28,7 +28,7 @@ Value::Value(const Value &other) {
       if (size_.len_ == BUSTUB_VALUE_NULL) {
         value_.varlen_ = nullptr;
       } else {
-        if (manage_data_) {
+        if (manage_data_ && !IsVarlenInlined()) {
           value_.varlen_ = new char[size_.len_];
           memcpy(value_.varlen_, other.value_.varlen_, size_.len_);
         } else {
@@ -221,10 +221,13 @@ Value::Value(TypeId type, const char *data, uint32_t len, bool manage_data) : Va
         manage_data_ = manage_data;
         if (manage_data_) {
           assert(len < BUSTUB_VARCHAR_MAX_LEN);
-          value_.varlen_ = new char[len];
-          assert(value_.varlen_ != nullptr);
           size_.len_ = len;
-          memcpy(value_.varlen_, data, len);
+          if (IsVarlenInlined()) {
+            memcpy(value_.inline_varlen_, data, len);
+          } else {
+            value_.varlen_ = new char[len];
+            memcpy(value_.varlen_, data, len);
+          }
         } else {
           // FUCK YOU GCC I do what I want.
           value_.const_varlen_ = data;
@@ -243,10 +246,13 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
       manage_data_ = true;
       // TODO(TAs): How to represent a null string here?
       uint32_t len = static_cast<uint32_t>(data.length()) + 1;
-      value_.varlen_ = new char[len];
-      assert(value_.varlen_ != nullptr);
       size_.len_ = len;
-      memcpy(value_.varlen_, data.c_str(), len);
+      if (IsVarlenInlined()) {
+        memcpy(value_.inline_varlen_, data.c_str(), len);
+      } else {
+        value_.varlen_ = new char[len];
+        memcpy(value_.varlen_, data.c_str(), len);
+      }
       break;
     }
     default:
@@ -258,7 +264,7 @@ Value::Value(TypeId type, const std::string &data) : Value(type) {
 Value::~Value() {
   switch (type_id_) {
     case TypeId::VARCHAR:
-      if (manage_data_) {
+      if (manage_data_ && !IsVarlenInlined()) {
         delete[] value_.varlen_;
       }
       break;
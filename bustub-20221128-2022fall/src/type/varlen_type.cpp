@@ -41,7 +41,7 @@ VarlenType::VarlenType(TypeId type) : Type(type) {}
 VarlenType::~VarlenType() = default;
 
 // Access the raw variable length data
-auto VarlenType::GetData(const Value &val) const -> const char * { return val.value_.varlen_; }
+auto VarlenType::GetData(const Value &val) const -> const char * { return val.GetVarlen(); }
 
 // Get the length of the variable length data (including the length field)
 auto VarlenType::GetLength(const Value &val) const -> uint32_t { return val.size_.len_; }
@@ -162,7 +162,7 @@ void VarlenType::SerializeTo(const Value &val, char *storage) const {
     return;
   }
   memcpy(storage, &len, sizeof(uint32_t));
-  memcpy(storage + sizeof(uint32_t), val.value_.varlen_, len);
+  memcpy(storage + sizeof(uint32_t), val.GetVarlen(), len);
 }
 
 // Deserialize a value of the given type from the given storage space.
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_test.cpp
+//
+// Identification: test/common/arena_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstring>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/arena.h"
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple_batch.h"
+#include "type/value_factory.h"
+
+/** Calls to the global operator new, counted for the allocation benchmark */
+static std::atomic<size_t> allocations{0};
+
+auto operator new(size_t size) -> void * {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {  // NOLINT
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete(void *ptr, size_t /* size */) noexcept { std::free(ptr); }  // NOLINT
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, ReusesBlocksOfPool) {
+  ArenaBlockPool pool;
+  {
+    Arena arena(&pool);
+    char *first = arena.Allocate(3);
+    char *second = arena.Allocate(8);
+    EXPECT_EQ(first + 8, second) << "allocations are 8-byte aligned";
+    // Fills the first block, and takes a second one.
+    for (size_t allocated = 16; allocated < ARENA_BLOCK_SIZE; allocated += 1024) {
+      arena.Allocate(1024);
+    }
+    EXPECT_EQ(2, pool.GetAllocatedBlocks());
+    // A large allocation gets memory of its own.
+    arena.Allocate(ARENA_BLOCK_SIZE);
+    EXPECT_EQ(2, pool.GetAllocatedBlocks());
+    EXPECT_EQ(3 * ARENA_BLOCK_SIZE, arena.GetMemoryUsage());
+
+    arena.Reset();
+    EXPECT_EQ(0, arena.GetMemoryUsage());
+    arena.Allocate(8);
+    Arena other(&pool);
+    other.Allocate(8);
+    EXPECT_EQ(2, pool.GetAllocatedBlocks()) << "arenas reuse the blocks given back to the pool";
+    Arena third(&pool);
+    third.Allocate(8);
+    EXPECT_EQ(3, pool.GetAllocatedBlocks());
+  }
+  // The blocks of destroyed arenas go back to the pool as well.
+  Arena arena(&pool);
+  for (int i = 0; i < 12; i++) {
+    arena.Allocate(ARENA_BLOCK_SIZE / 4);
+  }
+  EXPECT_EQ(3 * ARENA_BLOCK_SIZE, arena.GetMemoryUsage());
+  EXPECT_EQ(3, pool.GetAllocatedBlocks());
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, TuplesInArena) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}, Column{"c", TypeId::VARCHAR, 64}}};
+  TupleBatch batch;
+  batch.Reset(&schema);
+  for (int32_t i = 0; i < 100; i++) {
+    // Short strings are kept in the value itself, long ones in an allocation of their own.
+    batch.AppendRow({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i)),
+                     i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                 : ValueFactory::GetVarcharValue(std::string(i, 'x'))});
+  }
+
+  ArenaBlockPool pool;
+  Arena arena(&pool);
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < batch.Size(); i++) {
+    tuples.push_back(batch.GetTuple(i, &arena));
+  }
+  EXPECT_EQ(1, pool.GetAllocatedBlocks());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    ASSERT_FALSE(tuples[i].IsAllocated());
+    Tuple owned = batch.GetTuple(i);
+    ASSERT_TRUE(owned.IsAllocated());
+    ASSERT_EQ(owned.GetLength(), tuples[i].GetLength());
+    ASSERT_EQ(0, std::memcmp(owned.GetData(), tuples[i].GetData(), owned.GetLength()));
+    for (uint32_t column = 0; column < schema.GetColumnCount(); column++) {
+      const auto value = tuples[i].GetValue(&schema, column);
+      ASSERT_EQ(batch.GetValue(i, column).ToString(), value.ToString()) << i << ", " << column;
+      // Copies and moves keep the data wherever it is kept.
+      Value copy = value;
+      Value moved = std::move(copy);
+      ASSERT_EQ(value.ToString(), moved.ToString()) << i << ", " << column;
+    }
+    // A tuple that outlives the arena has to own its data.
+    tuples[i].Materialize();
+  }
+  arena.Reset();
+  EXPECT_EQ(std::to_string(99), tuples[99].GetValue(&schema, 1).ToString());
+  EXPECT_EQ(std::string(99, 'x'), tuples[99].GetValue(&schema, 2).ToString());
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, DISABLED_GraphQueryBenchmark) {
+  // The graph of p3.15-integration-1.slt, scaled up: every node has an edge to the next nodes.
+  const int32_t nodes = 300;
+  const int32_t edges_per_node = 10;
+  const int rounds = 5;
+  auto bustub = std::make_unique<BustubInstance>();
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{"src", TypeId::INTEGER}, Column{"dst", TypeId::INTEGER},
+                 Column{"src_label", TypeId::VARCHAR, 8}, Column{"dst_label", TypeId::VARCHAR, 8},
+                 Column{"distance", TypeId::INTEGER}}};
+  auto *table_info = bustub->catalog_->CreateTable(txn, "graph", schema);
+  for (int32_t src = 0; src < nodes; src++) {
+    for (int32_t i = 1; i <= edges_per_node; i++) {
+      const int32_t dst = (src + i) % nodes;
+      std::vector<Value> values{ValueFactory::GetIntegerValue(src), ValueFactory::GetIntegerValue(dst),
+                                ValueFactory::GetVarcharValue("{" + std::to_string(src) + "}"),
+                                ValueFactory::GetVarcharValue("{" + std::to_string(dst) + "}"),
+                                ValueFactory::GetIntegerValue(i)};
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(Tuple{values, &schema}, &rid, txn));
+    }
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql("set execution_threads=1;", writer);
+  const std::string one_hop =
+      "select src, dst, src_label, dst_label, min(distance) as distance from ("
+      "select l.src as src, r.dst as dst, l.src_label as src_label, r.dst_label as dst_label, "
+      "(l.distance + r.distance) as distance from graph l inner join graph r on l.dst = r.src"
+      ") group by src, dst, src_label, dst_label";
+  const std::string two_hops =
+      "select src, dst, src_label, dst_label, min(distance) as distance from ("
+      "select l.src as src, r.dst as dst, l.src_label as src_label, r.dst_label as dst_label, "
+      "(l.distance + r.distance) as distance from (" +
+      one_hop + ") l inner join graph r on l.dst = r.src) group by src, dst, src_label, dst_label";
+  // The shortest paths within one and two steps, as in the test, and the paths within one step sorted.
+  for (const auto &query :
+       {"select count(distance), sum(distance) from (" + one_hop + ");",
+        "select count(distance), sum(distance) from (" + two_hops + ");",
+        std::string("select count(*) from (select * from (select l.src_label as s, r.dst_label, l.distance + "
+                    "r.distance as d from graph l inner join graph r on l.dst = r.src) order by d, s);")}) {
+    const auto allocations_before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      ss.str("");
+      bustub->ExecuteSql(query, writer);
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%6.1f ms, %8zu allocations per query, result %s", static_cast<double>(ms) / rounds,  // NOLINT
+                (allocations.load() - allocations_before) / rounds, ss.str().c_str());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // duplicate pairs are rejected, duplicate keys are not
+  EXPECT_FALSE(ht.Insert(nullptr, 1, 1));
+  EXPECT_TRUE(ht.Insert(nullptr, 1, 2));
+  std::vector<int> res;
+  ht.GetValue(nullptr, 1, &res);
+  EXPECT_EQ(2, res.size());
+
+  EXPECT_TRUE(ht.Remove(nullptr, 1, 1));
+  EXPECT_FALSE(ht.Remove(nullptr, 1, 1));
+  res.clear();
+  ht.GetValue(nullptr, 1, &res);
+  EXPECT_EQ(1, res.size());
+  EXPECT_EQ(2, res[0]);
+
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  size_t initial_size = ht.GetSize();
+  const int num_keys = 3000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GT(ht.GetSize(), initial_size);
+
+  // Start a resize by hand and check every key is visible while blocks are still being migrated.
+  ht.Resize(ht.GetSize());
+  EXPECT_TRUE(ht.IsResizing());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "Lost key " << i << " during migration";
+    EXPECT_EQ(i, res[0]);
+    // Each remove moves one more block of the old layout.
+    if (i % 2 == 0) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    }
+  }
+  EXPECT_FALSE(ht.IsResizing());
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 2 == 0 ? 0 : 1, res.size());
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentResizeTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 500, HashFunction<int>());
+
+  const int num_threads = 4;
+  const int keys_per_thread = 1000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([tid, &ht]() {
+      const int start = tid * keys_per_thread;
+      for (int i = start; i < start + keys_per_thread; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        // Keys written by this thread must never disappear, whatever resize the others are driving.
+        std::vector<int> res;
+        ht.GetValue(nullptr, start + (i - start) / 7 * 7, &res);
+        EXPECT_EQ(1, res.size());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size());
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
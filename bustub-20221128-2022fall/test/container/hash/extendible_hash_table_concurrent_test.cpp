@@ -0,0 +1,112 @@
+/**
+ * extendible_hash_table_concurrent_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ExtendibleHashTableConcurrentTest, MixedOperationsTest) {
+  const int num_runs = 10;
+  const int num_threads = 8;
+  const int keys_per_thread = 2000;
+
+  for (int run = 0; run < num_runs; run++) {
+    auto table = std::make_unique<ExtendibleHashTable<int, int>>(4);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([tid, &table]() {
+        const int start = tid * keys_per_thread;
+        for (int key = start; key < start + keys_per_thread; key++) {
+          table->Insert(key, key);
+          int val;
+          EXPECT_TRUE(table->Find(key, val));
+          EXPECT_EQ(key, val);
+        }
+        // Overwrite every key, then drop the odd ones.
+        for (int key = start; key < start + keys_per_thread; key++) {
+          table->Insert(key, -key);
+          if (key % 2 == 1) {
+            EXPECT_TRUE(table->Remove(key));
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    for (int key = 0; key < num_threads * keys_per_thread; key++) {
+      int val;
+      if (key % 2 == 1) {
+        EXPECT_FALSE(table->Find(key, val));
+      } else {
+        EXPECT_TRUE(table->Find(key, val));
+        EXPECT_EQ(-key, val);
+      }
+    }
+  }
+}
+
+auto ExtendibleHashTableBenchmarkCall(size_t num_threads, bool with_global_mutex) -> size_t {
+  const int total_ops = 1 << 20;
+  const int key_space = 1 << 16;
+  ExtendibleHashTable<int, int> table(16);
+  for (int key = 0; key < key_space; key++) {
+    table.Insert(key, key);
+  }
+
+  std::mutex mtx;
+  std::vector<std::thread> threads;
+  auto clock_start = std::chrono::system_clock::now();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      uint32_t seed = tid + 1;
+      for (size_t i = 0; i < total_ops / num_threads; i++) {
+        seed = seed * 1103515245 + 12345;
+        int key = static_cast<int>((seed >> 8) % key_space);
+        int val;
+        if (with_global_mutex) {
+          mtx.lock();
+        }
+        // 90% lookups, 10% updates, the mix seen by the buffer pool page table.
+        if (i % 10 == 0) {
+          table.Insert(key, key);
+        } else {
+          table.Find(key, val);
+        }
+        if (with_global_mutex) {
+          mtx.unlock();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto clock_end = std::chrono::system_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+}
+
+TEST(ExtendibleHashTableConcurrentTest, DISABLED_ScalingBenchmark) {  // NOLINT
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8, 16, 32}) {
+    auto time_ms = ExtendibleHashTableBenchmarkCall(num_threads, false);
+    auto time_ms_serialized = ExtendibleHashTableBenchmarkCall(num_threads, true);
+    std::cout << "Threads: " << num_threads << " Bucket Latches: " << time_ms << "ms"
+              << " Serialized: " << time_ms_serialized << "ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression_test.cpp
+//
+// Identification: test/execution/compiled_expression_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/compiled_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using ExprRef = AbstractExpressionRef;
+
+static auto Col(uint32_t idx, TypeId type) -> ExprRef { return std::make_shared<ColumnValueExpression>(0, idx, type); }
+static auto Const(const Value &value) -> ExprRef { return std::make_shared<ConstantValueExpression>(value); }
+static auto Cmp(ExprRef l, ExprRef r, ComparisonType type) -> ExprRef {
+  return std::make_shared<ComparisonExpression>(std::move(l), std::move(r), type);
+}
+static auto Logic(ExprRef l, ExprRef r, LogicType type) -> ExprRef {
+  return std::make_shared<LogicExpression>(std::move(l), std::move(r), type);
+}
+static auto Arith(ExprRef l, ExprRef r, ArithmeticType type) -> ExprRef {
+  return std::make_shared<ArithmeticExpression>(std::move(l), std::move(r), type);
+}
+
+/** Fills a batch of (INTEGER, BIGINT, DECIMAL, BOOLEAN) rows, with a null in every fifth value of each column */
+static void FillBatch(TupleBatch *batch, const Schema *schema, size_t rows, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int32_t> dist(-100, 100);
+  auto maybe_null = [&](TypeId type, const Value &value) {
+    return gen() % 5 == 0 ? ValueFactory::GetNullValueByType(type) : value;
+  };
+  batch->Reset(schema);
+  for (size_t i = 0; i < rows; i++) {
+    batch->AppendRow({maybe_null(TypeId::INTEGER, ValueFactory::GetIntegerValue(dist(gen))),
+                      maybe_null(TypeId::BIGINT, ValueFactory::GetBigIntValue(dist(gen))),
+                      maybe_null(TypeId::DECIMAL, ValueFactory::GetDecimalValue(dist(gen) / 4.0)),
+                      maybe_null(TypeId::BOOLEAN, ValueFactory::GetBooleanValue(dist(gen) > 0))});
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, SameResultAsInterpreted) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::BIGINT}, Column{"c", TypeId::DECIMAL},
+                 Column{"d", TypeId::BOOLEAN}}};
+  auto a = Col(0, TypeId::INTEGER);
+  auto b = Col(1, TypeId::BIGINT);
+  auto c = Col(2, TypeId::DECIMAL);
+  auto d = Col(3, TypeId::BOOLEAN);
+  auto int_null = Const(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+
+  const std::vector<ExprRef> exprs{
+      Cmp(a, Const(ValueFactory::GetIntegerValue(10)), ComparisonType::GreaterThan),
+      Cmp(a, b, ComparisonType::LessThanOrEqual),
+      Cmp(c, a, ComparisonType::GreaterThanOrEqual),
+      Cmp(Const(ValueFactory::GetDecimalValue(2.5)), b, ComparisonType::NotEqual),
+      Cmp(d, Const(ValueFactory::GetBooleanValue(true)), ComparisonType::Equal),
+      Cmp(a, int_null, ComparisonType::Equal),
+      Arith(a, Const(ValueFactory::GetIntegerValue(7)), ArithmeticType::Minus),
+      Arith(Arith(a, a, ArithmeticType::Plus), int_null, ArithmeticType::Plus),
+      Cmp(Arith(a, a, ArithmeticType::Plus), b, ComparisonType::LessThan),
+      Logic(d, Cmp(a, b, ComparisonType::Equal), LogicType::And),
+      Logic(d, Cmp(c, b, ComparisonType::LessThan), LogicType::Or),
+      Logic(Logic(d, Cmp(a, b, ComparisonType::GreaterThan), LogicType::Or), Cmp(c, a, ComparisonType::NotEqual),
+            LogicType::And),
+  };
+
+  TupleBatch batch;
+  for (uint32_t seed = 0; seed < 4; seed++) {
+    FillBatch(&batch, &schema, 1000, seed);
+    if (seed % 2 == 1) {
+      // Narrow the batch down to every third row, the compiled expressions must only see the selected rows.
+      std::vector<uint32_t> selection;
+      for (uint32_t i = 0; i < 1000; i += 3) {
+        selection.push_back(i);
+      }
+      batch.SetSelection(std::move(selection));
+    }
+
+    for (const auto &expr : exprs) {
+      auto compiled = CompiledExpression::Compile(*expr);
+      ASSERT_NE(nullptr, compiled) << expr->ToString();
+
+      std::vector<Value> expected;
+      std::vector<Value> actual;
+      expr->EvaluateBatch(batch, &expected);
+      compiled->EvaluateBatch(batch, &actual);
+      ASSERT_EQ(expected.size(), actual.size());
+      for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(expected[i].IsNull(), actual[i].IsNull()) << expr->ToString() << " row " << i;
+        if (!expected[i].IsNull()) {
+          ASSERT_EQ(CmpBool::CmpTrue, expected[i].CompareEquals(actual[i])) << expr->ToString() << " row " << i;
+        }
+      }
+
+      if (expr->GetReturnType() == TypeId::BOOLEAN) {
+        std::vector<uint32_t> expected_selection;
+        for (size_t i = 0; i < expected.size(); i++) {
+          if (!expected[i].IsNull() && expected[i].GetAs<bool>()) {
+            expected_selection.push_back(batch.RowAt(i));
+          }
+        }
+        std::vector<uint32_t> selection;
+        compiled->Select(batch, &selection);
+        ASSERT_EQ(expected_selection, selection) << expr->ToString();
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, UnsupportedExpressions) {
+  auto a = Col(0, TypeId::INTEGER);
+  // Bare columns and constants are not worth compiling.
+  ASSERT_EQ(nullptr, CompiledExpression::Compile(*a));
+  ASSERT_EQ(nullptr, CompiledExpression::Compile(*Const(ValueFactory::GetIntegerValue(1))));
+  // Strings are not supported, and neither are columns of the right side of a join.
+  auto varchar = Cmp(Col(0, TypeId::VARCHAR), Const(ValueFactory::GetVarcharValue("x")), ComparisonType::Equal);
+  ASSERT_EQ(nullptr, CompiledExpression::Compile(*varchar));
+  auto join = Cmp(a, std::make_shared<ColumnValueExpression>(1, 0, TypeId::INTEGER), ComparisonType::Equal);
+  ASSERT_EQ(nullptr, CompiledExpression::Compile(*join));
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, DISABLED_FilterThroughputBenchmark) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::BIGINT}, Column{"c", TypeId::DECIMAL},
+                 Column{"d", TypeId::BOOLEAN}}};
+  // a > 10 AND (b < 50 OR c >= 0)
+  auto predicate = Logic(Cmp(Col(0, TypeId::INTEGER), Const(ValueFactory::GetIntegerValue(10)),
+                             ComparisonType::GreaterThan),
+                         Logic(Cmp(Col(1, TypeId::BIGINT), Const(ValueFactory::GetBigIntValue(50)),
+                                   ComparisonType::LessThan),
+                               Cmp(Col(2, TypeId::DECIMAL), Const(ValueFactory::GetDecimalValue(0)),
+                                   ComparisonType::GreaterThanOrEqual),
+                               LogicType::Or),
+                         LogicType::And);
+  auto compiled = CompiledExpression::Compile(*predicate);
+  ASSERT_NE(nullptr, compiled);
+
+  TupleBatch batch;
+  FillBatch(&batch, &schema, TUPLE_BATCH_SIZE, 42);
+  const size_t rounds = 10000000 / TUPLE_BATCH_SIZE;
+
+  auto measure = [&](const char *name, auto &&filter) {
+    size_t selected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; i++) {
+      selected += filter();
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-12s %zu rows in %ld ms, %.1f M rows/s, %zu selected\n", name, rounds * TUPLE_BATCH_SIZE,
+                static_cast<long>(ms), rounds * TUPLE_BATCH_SIZE / 1000.0 / std::max<int64_t>(ms, 1), selected);
+  };
+
+  std::vector<Value> values;
+  measure("interpreted", [&] {
+    predicate->EvaluateBatch(batch, &values);
+    size_t selected = 0;
+    for (const auto &value : values) {
+      selected += !value.IsNull() && value.GetAs<bool>() ? 1 : 0;
+    }
+    return selected;
+  });
+  std::vector<uint32_t> selection;
+  measure("compiled", [&] {
+    compiled->Select(batch, &selection);
+    return selection.size();
+  });
+}
+
+}  // namespace bustub
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels_test.cpp
+//
+// Identification: test/execution/filter_kernels_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/filter_kernels.h"
+#include "gtest/gtest.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+template <typename T>
+static void CheckKernel(T null) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int32_t> dist(-20, 20);
+  const std::vector<ComparisonType> comparisons{ComparisonType::Equal,           ComparisonType::NotEqual,
+                                                ComparisonType::LessThan,        ComparisonType::LessThanOrEqual,
+                                                ComparisonType::GreaterThan,     ComparisonType::GreaterThanOrEqual};
+  for (size_t rows : {0, 1, 3, 63, 64, 65, 130, 1024, 1027}) {
+    std::vector<T> values(rows);
+    for (auto &value : values) {
+      value = dist(gen) == 0 ? null : static_cast<T>(dist(gen));
+    }
+    const auto constant = static_cast<T>(dist(gen));
+    for (auto comparison : comparisons) {
+      // Garbage in the bitmap must be overwritten.
+      std::vector<uint64_t> bitmap(BitmapWords(rows), ~uint64_t{0});
+      CompareWithConstant(comparison, values.data(), rows, constant, bitmap.data());
+      for (size_t i = 0; i < rows; i++) {
+        bool expected = false;
+        if (values[i] != null) {
+          switch (comparison) {
+            case ComparisonType::Equal:
+              expected = values[i] == constant;
+              break;
+            case ComparisonType::NotEqual:
+              expected = values[i] != constant;
+              break;
+            case ComparisonType::LessThan:
+              expected = values[i] < constant;
+              break;
+            case ComparisonType::LessThanOrEqual:
+              expected = values[i] <= constant;
+              break;
+            case ComparisonType::GreaterThan:
+              expected = values[i] > constant;
+              break;
+            case ComparisonType::GreaterThanOrEqual:
+              expected = values[i] >= constant;
+              break;
+          }
+        }
+        ASSERT_EQ(expected, ((bitmap[i / 64] >> (i % 64)) & 1) == 1) << rows << " rows, row " << i;
+      }
+      if (rows % 64 != 0) {
+        ASSERT_EQ(0, bitmap.back() >> (rows % 64)) << "bits past the last row must be cleared";
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, SameResultAsScalar) {
+  CheckKernel<int32_t>(BUSTUB_INT32_NULL);
+  CheckKernel<int64_t>(BUSTUB_INT64_NULL);
+  CheckKernel<double>(BUSTUB_DECIMAL_NULL);
+}
+
+/** Creates a table t(a INTEGER, b BIGINT, c DECIMAL) through the catalog, as the insert executor is not available */
+static void CreateTable(BustubInstance *bustub, size_t rows) {
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::BIGINT}, Column{"c", TypeId::DECIMAL}}};
+  auto *table_info = bustub->catalog_->CreateTable(txn, "t", schema);
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int32_t> dist(0, 9999);
+  for (size_t i = 0; i < rows; i++) {
+    auto maybe_null = [&](TypeId type, const Value &value) {
+      return gen() % 10 == 0 ? ValueFactory::GetNullValueByType(type) : value;
+    };
+    std::vector<Value> values{maybe_null(TypeId::INTEGER, ValueFactory::GetIntegerValue(dist(gen))),
+                              maybe_null(TypeId::BIGINT, ValueFactory::GetBigIntValue(dist(gen))),
+                              maybe_null(TypeId::DECIMAL, ValueFactory::GetDecimalValue(dist(gen) / 8.0))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple{values, &schema}, &rid, txn));
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+}
+
+static auto RunQuery(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(ss, row);) {
+    rows.push_back(row);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, ScanSameResultAsFilter) {
+  auto bustub = std::make_unique<BustubInstance>();
+  CreateTable(bustub.get(), 5000);
+
+  const std::vector<std::string> queries{
+      "select a, b, c from t where a > 1000;",
+      "select a, b from t where 5000 >= b and c < 600;",
+      "select a, c from t where a != 42 and c >= 10 and b <= 9000;",
+      "select count(*) from t where b = 77 or a < 100;",
+      "select count(*), min(a) from t where a < 5000 and (b < 10 or c > 1000);",
+  };
+  for (const auto &query : queries) {
+    // The starter rules do not merge the filter into the scan, so the filter executor evaluates the predicate.
+    RunQuery(bustub.get(), "set force_optimizer_starter_rule=yes;");
+    auto expected = RunQuery(bustub.get(), query);
+    RunQuery(bustub.get(), "set force_optimizer_starter_rule=no;");
+    EXPECT_EQ(expected, RunQuery(bustub.get(), query)) << query;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, DISABLED_ScanThroughputBenchmark) {
+  // Every insert walks the table heap from its first page, so the table is kept small enough for the buffer pool and
+  // the queries are repeated instead.
+  const size_t rows = 15000;
+  const int rounds = 200;
+  auto bustub = std::make_unique<BustubInstance>();
+  CreateTable(bustub.get(), rows);
+  RunQuery(bustub.get(), "set execution_threads=1;");
+
+  for (const auto *query : {"select count(*) from t;", "select count(*) from t where a > 1000;",
+                            "select count(*) from t where a > 1000 or a > 1000;"}) {
+    std::string result;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      result = RunQuery(bustub.get(), query)[0];
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-50s %zu rows in %5ld ms, %.1f M rows/s, result %s\n", query, rows * rounds,  // NOLINT
+                static_cast<long>(ms), rows * rounds / 1000.0 / std::max<int64_t>(ms, 1), result.c_str());
+  }
+}
+
+}  // namespace bustub
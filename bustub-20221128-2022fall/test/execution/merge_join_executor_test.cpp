@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor_test.cpp
+//
+// Identification: test/execution/merge_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Creates a table with an INTEGER key and an INTEGER payload through the catalog, as the insert executor is not
+ * available. A tenth of the keys are null, and hot_rows more rows share the key hot_key.
+ */
+static void CreateTable(BustubInstance *bustub, const std::string &name, size_t rows, int32_t min_key,
+                        int32_t max_key, size_t hot_rows, int32_t hot_key) {
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{name + "_key", TypeId::INTEGER}, Column{name + "_val", TypeId::INTEGER}}};
+  auto *table_info = bustub->catalog_->CreateTable(txn, name, schema);
+  std::mt19937 gen(rows);
+  std::uniform_int_distribution<int32_t> dist(min_key, max_key);
+  for (size_t i = 0; i < rows + hot_rows; i++) {
+    auto key = i >= rows ? ValueFactory::GetIntegerValue(hot_key)
+               : gen() % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                 : ValueFactory::GetIntegerValue(dist(gen));
+    std::vector<Value> values{key, ValueFactory::GetIntegerValue(static_cast<int32_t>(i))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple{values, &schema}, &rid, txn));
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+}
+
+/** @return The rows produced by the query, sorted, as a hash join does not keep the order of its input */
+static auto RunQuery(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(ss, row);) {
+    rows.push_back(row);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// NOLINTNEXTLINE
+TEST(MergeJoinExecutorTest, SameResultAsHashJoin) {
+  auto bustub = std::make_unique<BustubInstance>();
+  // The hot key has more matches on the right than fit in a batch, and repeats on the left.
+  CreateTable(bustub.get(), "l", 3000, 0, 300, 3, 150);
+  CreateTable(bustub.get(), "r", 2000, 100, 400, 1500, 150);
+
+  for (const auto *join : {"inner", "left"}) {
+    const std::string hash_join = std::string("select * from l ") + join + " join r on l.l_key = r.r_key;";
+    const std::string merge_join = std::string("select * from (select * from l order by l_key) a ") + join +
+                                   " join (select * from r order by r_key) b on a.l_key = b.r_key;";
+    const auto explain = RunQuery(bustub.get(), "explain " + merge_join);
+    ASSERT_TRUE(std::any_of(explain.begin(), explain.end(),
+                            [](const std::string &line) { return line.find("MergeJoin") == 0; }))
+        << merge_join;
+
+    for (const auto *threads : {"1", "4"}) {
+      RunQuery(bustub.get(), std::string("set execution_threads=") + threads + ";");
+      auto expected = RunQuery(bustub.get(), hash_join);
+      ASSERT_FALSE(expected.empty());
+      EXPECT_EQ(expected, RunQuery(bustub.get(), merge_join)) << join << " join, " << threads << " threads";
+    }
+  }
+
+  // The sort on the right is not on the join key, so there is no order to merge on.
+  const auto explain = RunQuery(
+      bustub.get(), "explain select * from (select * from l order by l_key) a inner join "
+                    "(select * from r order by r_val) b on a.l_key = b.r_key;");
+  ASSERT_TRUE(std::none_of(explain.begin(), explain.end(),
+                           [](const std::string &line) { return line.find("MergeJoin") != std::string::npos; }));
+}
+
+// NOLINTNEXTLINE
+TEST(MergeJoinExecutorTest, DISABLED_MergeJoinThroughputBenchmark) {
+  const int rounds = 5;
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  RunQuery(bustub.get(), "set execution_threads=1;");
+
+  // The sorts alone, then the same sorts merge joined, then a hash join of the unsorted tables.
+  for (const auto *query :
+       {"select count(*) from (select x from __mock_t1_50k order by x);",
+        "select count(*) from (select x from __mock_t2_100k order by x);",
+        "select count(*) from (select x from __mock_t1_50k order by x) a inner join "
+        "(select x from __mock_t2_100k order by x) b on a.x = b.x;",
+        "select count(*) from __mock_t1_50k a inner join __mock_t2_100k b on a.x = b.x;"}) {
+    std::string result;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      result = RunQuery(bustub.get(), query)[0];
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%5ld ms per query, result %s: %s\n", static_cast<long>(ms / rounds), result.c_str(),  // NOLINT
+                query);
+  }
+}
+
+}  // namespace bustub
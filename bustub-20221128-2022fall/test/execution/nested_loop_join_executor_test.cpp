@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_loop_join_executor_test.cpp
+//
+// Identification: test/execution/nested_loop_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Creates a table with an INTEGER key and an INTEGER payload through the catalog, as the insert executor is not
+ * available. A tenth of the keys are null.
+ * @return The keys of the rows, nullopt for the null keys
+ */
+static auto CreateTable(BustubInstance *bustub, const std::string &name, size_t rows, int32_t max_key)
+    -> std::vector<std::optional<int32_t>> {
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{name + "_key", TypeId::INTEGER}, Column{name + "_val", TypeId::INTEGER}}};
+  auto *table_info = bustub->catalog_->CreateTable(txn, name, schema);
+  std::mt19937 gen(rows);
+  std::uniform_int_distribution<int32_t> dist(0, max_key);
+  std::vector<std::optional<int32_t>> keys;
+  for (size_t i = 0; i < rows; i++) {
+    auto key = gen() % 10 == 0 ? std::nullopt : std::make_optional(dist(gen));
+    keys.push_back(key);
+    std::vector<Value> values{key ? ValueFactory::GetIntegerValue(*key)
+                                  : ValueFactory::GetNullValueByType(TypeId::INTEGER),
+                              ValueFactory::GetIntegerValue(static_cast<int32_t>(i))};
+    RID rid;
+    EXPECT_TRUE(table_info->table_->InsertTuple(Tuple{values, &schema}, &rid, txn));
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+  return keys;
+}
+
+/** @return The rows produced by the query, sorted */
+static auto RunQuery(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(ss, row);) {
+    rows.push_back(row);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// NOLINTNEXTLINE
+TEST(NestedLoopJoinExecutorTest, BlockSizeDoesNotChangeResult) {
+  auto bustub = std::make_unique<BustubInstance>();
+  // The left table spans many blocks of a page, and the right table more than one batch.
+  const auto left_keys = CreateTable(bustub.get(), "l", 1500, 1000);
+  const auto right_keys = CreateTable(bustub.get(), "r", 1200, 1000);
+
+  // A band join: every left row matches the right rows with a key a little larger, so many rows have no match.
+  auto matches = [](int32_t l, int32_t r) { return l < r && r < l + 5; };
+  for (const auto *join : {"inner", "left"}) {
+    const std::string query = std::string("select l_val, r_val from l ") + join +
+                              " join r on l.l_key < r.r_key and r.r_key < l.l_key + 5;";
+    // The predicate is not an equality, so the optimizer cannot turn the join into a hash join.
+    const auto explain = RunQuery(bustub.get(), "explain " + query);
+    ASSERT_TRUE(std::none_of(explain.begin(), explain.end(),
+                             [](const std::string &line) { return line.find("HashJoin") != std::string::npos; }))
+        << query;
+
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < left_keys.size(); i++) {
+      bool matched = false;
+      for (size_t j = 0; j < right_keys.size(); j++) {
+        if (left_keys[i] && right_keys[j] && matches(*left_keys[i], *right_keys[j])) {
+          expected.push_back(std::to_string(i) + "\t" + std::to_string(j) + "\t");
+          matched = true;
+        }
+      }
+      if (!matched && std::string(join) == "left") {
+        expected.push_back(std::to_string(i) + "\tinteger_null\t");
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_FALSE(expected.empty());
+
+    for (const auto *pages : {"1", "16", "1000"}) {
+      RunQuery(bustub.get(), std::string("set nlj_block_pages=") + pages + ";");
+      EXPECT_EQ(expected, RunQuery(bustub.get(), query)) << join << " join, " << pages << " pages";
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(NestedLoopJoinExecutorTest, DISABLED_BlockNestedLoopJoinBenchmark) {
+  auto bustub = std::make_unique<BustubInstance>();
+  CreateTable(bustub.get(), "l", 5000, 100000);
+  CreateTable(bustub.get(), "r", 2000, 100000);
+  RunQuery(bustub.get(), "set execution_threads=1;");
+
+  // A block of one page rescans the right table for every few dozen left rows.
+  const std::string query = "select count(*) from l inner join r on l.l_key < r.r_key and r.r_key < l.l_key + 50;";
+  for (const auto *pages : {"1", "16", "64"}) {
+    RunQuery(bustub.get(), std::string("set nlj_block_pages=") + pages + ";");
+    auto start = std::chrono::steady_clock::now();
+    auto result = RunQuery(bustub.get(), query)[0];
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%3s pages per block: %5ld ms, result %s\n", pages, static_cast<long>(ms), result.c_str());  // NOLINT
+  }
+}
+
+}  // namespace bustub
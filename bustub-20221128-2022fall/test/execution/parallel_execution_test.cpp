@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_execution_test.cpp
+//
+// Identification: test/execution/parallel_execution_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** @return The rows produced by the query, sorted, as the parallel plans do not keep the order of their input */
+static auto RunQuery(BustubInstance *bustub, const std::string &threads, const std::string &sql)
+    -> std::vector<std::string> {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  EXPECT_TRUE(bustub->ExecuteSql("set execution_threads=" + threads + ";", writer));
+  EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(ss, row);) {
+    rows.push_back(row);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelExecutionTest, SameResultAsSerial) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  bustub->GenerateTestTable();
+
+  const std::vector<std::string> queries{
+      "select count(*), min(x), max(y) from __mock_t1_50k;",
+      "select v1, count(*), min(v2), min(v3), max(v4) from __mock_agg_input_big where v5 > 3 group by v1;",
+      "select colB, count(*), min(colC), max(colD) from test_1 where colA >= 300 group by colB;",
+      "select count(*), count(b.x), max(b.y) from __mock_t1_50k a left join __mock_t2_100k b on a.x = b.x;",
+      "select a.colA, b.colA from test_1 a inner join test_2 b on a.colB = b.colC where a.colD < 2000;",
+      // A build side that spills some partitions on every worker, and a probe side that every worker probes with.
+      "select a.x, a.y, b.y from __mock_t1_50k a inner join __mock_t2_100k b on a.x = b.x where a.y < 40000000;",
+  };
+  for (const auto &query : queries) {
+    auto serial = RunQuery(bustub.get(), "1", query);
+    ASSERT_FALSE(serial.empty()) << query;
+    for (const auto *threads : {"2", "4"}) {
+      EXPECT_EQ(serial, RunQuery(bustub.get(), threads, query)) << query << " with " << threads << " threads";
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelExecutionTest, DISABLED_HashJoinBenchmark) {
+  const int rounds = 3;
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  const std::string query = "select count(*), max(b.y) from __mock_t4_1m a inner join __mock_t5_1m b on a.x = b.x;";
+  for (const auto *threads : {"1", "2", "4"}) {
+    std::vector<std::string> rows;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      rows = RunQuery(bustub.get(), threads, query);
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s threads: %5ld ms per query, %s\n", threads, static_cast<long>(ms / rounds),  // NOLINT
+                rows.empty() ? "" : rows[0].c_str());
+  }
+}
+
+}  // namespace bustub
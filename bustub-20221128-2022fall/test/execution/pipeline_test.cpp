@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pipeline_test.cpp
+//
+// Identification: test/execution/pipeline_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** @return The rows produced by the query, sorted, as a parallel pipeline does not keep the order of its input */
+static auto RunQuery(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(ss, row);) {
+    rows.push_back(row);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// NOLINTNEXTLINE
+TEST(PipelineTest, SameResultAsPull) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+
+  const std::vector<std::string> queries{
+      // Filters and projections over a scan.
+      "select x + 1, y from __mock_t1_50k where x > 3000 and y < 40000000;",
+      // Probes fused with the filter and the projection above them.
+      "select a.x, b.y + a.y from __mock_t1_50k a inner join __mock_t3_1k b on a.x = b.x where a.y > 5000;",
+      "select a.x, b.y from __mock_t1_50k a left join __mock_t3_1k b on a.x = b.x;",
+      // Two probes in one pipeline, the second of which spills its build side.
+      "select a.x, c.x from __mock_t3_1k a inner join __mock_t1_50k b on a.x = b.x "
+      "inner join __mock_t2_100k c on b.y = c.y;",
+      "select a.x, b.y from __mock_t3_1k a left join __mock_t2_100k b on a.x = b.x;",
+      // A pipeline breaker as the source.
+      "select x, c + 1 from (select x, count(*) as c from __mock_t3_1k group by x) where c > 0;",
+      "select x from __mock_t3_1k order by x limit 10;",
+  };
+  for (const auto *threads : {"1", "4"}) {
+    RunQuery(bustub.get(), std::string("set execution_threads=") + threads + ";");
+    for (const auto &query : queries) {
+      RunQuery(bustub.get(), "set push_execution=false;");
+      const auto expected = RunQuery(bustub.get(), query);
+      ASSERT_FALSE(expected.empty()) << query;
+      RunQuery(bustub.get(), "set push_execution=true;");
+      EXPECT_EQ(expected, RunQuery(bustub.get(), query)) << query << ", " << threads << " threads";
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PipelineTest, DISABLED_PushVsPullBenchmark) {
+  const int rounds = 5;
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  RunQuery(bustub.get(), "set execution_threads=1;");
+
+  for (const auto *query :
+       {"select x + 1, y from __mock_t4_1m where x > 250000;",
+        "select a.x, b.y from __mock_t2_100k a inner join __mock_t3_1k b on a.x = b.x where a.y > 1000;"}) {
+    for (const auto *mode : {"false", "true"}) {
+      RunQuery(bustub.get(), std::string("set push_execution=") + mode + ";");
+      size_t rows = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < rounds; i++) {
+        rows = RunQuery(bustub.get(), query).size();
+      }
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      std::printf("%s %5ld ms per query, %zu rows: %s\n", mode[0] == 't' ? "push" : "pull",  // NOLINT
+                  static_cast<long>(ms / rounds), rows, query);
+    }
+  }
+}
+
+}  // namespace bustub
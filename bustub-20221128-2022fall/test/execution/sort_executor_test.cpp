@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor_test.cpp
+//
+// Identification: test/execution/sort_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/loser_tree.h"
+#include "execution/sort_key.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** @return true if a sorts before b in ascending order, where nulls come first */
+static auto ValueLess(const Value &a, const Value &b) -> bool {
+  if (a.IsNull() || b.IsNull()) {
+    return a.IsNull() && !b.IsNull();
+  }
+  return a.CompareLessThan(b) == CmpBool::CmpTrue;
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, SortKeysCompareLikeValues) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> dist(-1000, 1000);
+  const std::vector<std::string> strings{"", "a", "ab", "abc", "b", "ba", std::string("a\0b", 3), std::string("a\0", 2),
+                                         "\xff", "z"};
+  auto random_value = [&](TypeId type) {
+    if (gen() % 8 == 0) {
+      return ValueFactory::GetNullValueByType(type);
+    }
+    // Mostly values around zero, sometimes the extremes of the type.
+    const auto extreme = int64_t{1} << (8 * Type::GetTypeSize(type) - 2);
+    int64_t n = gen() % 16 == 0 ? (gen() % 2 == 0 ? -extreme : extreme) : dist(gen);
+    switch (type) {
+      case TypeId::TINYINT:
+        return ValueFactory::GetTinyIntValue(static_cast<int8_t>(n % 100));
+      case TypeId::SMALLINT:
+        return ValueFactory::GetSmallIntValue(static_cast<int16_t>(n));
+      case TypeId::INTEGER:
+        return ValueFactory::GetIntegerValue(static_cast<int32_t>(n));
+      case TypeId::BIGINT:
+        return ValueFactory::GetBigIntValue(n * 1000000000);
+      case TypeId::DECIMAL:
+        return ValueFactory::GetDecimalValue(static_cast<double>(dist(gen)) / 7.0);
+      case TypeId::BOOLEAN:
+        return ValueFactory::GetBooleanValue(n > 0);
+      default:
+        return ValueFactory::GetVarcharValue(strings[gen() % strings.size()]);
+    }
+  };
+
+  for (auto type : {TypeId::BOOLEAN, TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT,
+                    TypeId::DECIMAL, TypeId::VARCHAR}) {
+    for (bool descending : {false, true}) {
+      for (int i = 0; i < 2000; i++) {
+        // A second value after the first checks that the keys of the first do not bleed into each other.
+        std::vector<Value> a{random_value(type), random_value(TypeId::INTEGER)};
+        std::vector<Value> b{gen() % 4 == 0 ? a[0] : random_value(type), random_value(TypeId::INTEGER)};
+        std::string key_a;
+        std::string key_b;
+        for (const auto &value : a) {
+          SortKeyEncoder::EncodeValue(value, descending, &key_a);
+        }
+        for (const auto &value : b) {
+          SortKeyEncoder::EncodeValue(value, descending, &key_b);
+        }
+        bool equal = !ValueLess(a[0], b[0]) && !ValueLess(b[0], a[0]);
+        bool expected = descending ? ValueLess(b[0], a[0]) : ValueLess(a[0], b[0]);
+        if (equal) {
+          expected = descending ? ValueLess(b[1], a[1]) : ValueLess(a[1], b[1]);
+        }
+        ASSERT_EQ(expected, SortKeyLess(key_a, key_b))
+            << Type::TypeIdToString(type) << (descending ? " DESC " : " ASC ") << a[0].ToString() << ", "
+            << a[1].ToString() << " vs " << b[0].ToString() << ", " << b[1].ToString();
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, LoserTreeMerges) {
+  std::mt19937 gen(0);
+  for (size_t inputs = 1; inputs <= 40; inputs++) {
+    std::vector<std::vector<int>> runs(inputs);
+    std::vector<int> expected;
+    for (auto &run : runs) {
+      run.resize(gen() % 20);
+      for (auto &value : run) {
+        value = static_cast<int>(gen() % 100);
+        expected.push_back(value);
+      }
+      std::sort(run.begin(), run.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<size_t> positions(inputs, 0);
+    auto less = [&](size_t a, size_t b) {
+      if (positions[a] == runs[a].size()) {
+        return false;
+      }
+      return positions[b] == runs[b].size() || runs[a][positions[a]] < runs[b][positions[b]];
+    };
+    LoserTree tree;
+    tree.Init(inputs, less);
+    std::vector<int> merged;
+    while (positions[tree.Winner()] < runs[tree.Winner()].size()) {
+      merged.push_back(runs[tree.Winner()][positions[tree.Winner()]++]);
+      tree.Replay(less);
+    }
+    ASSERT_EQ(expected, merged) << inputs << " inputs";
+  }
+}
+
+/** Creates a table t(a INTEGER, b VARCHAR, c DECIMAL) through the catalog, as the insert executor is not available */
+static auto CreateTable(BustubInstance *bustub, size_t rows) -> std::vector<std::vector<Value>> {
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}, Column{"c", TypeId::DECIMAL}}};
+  auto *table_info = bustub->catalog_->CreateTable(txn, "t", schema);
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int32_t> dist(-500, 500);
+  std::vector<std::vector<Value>> table;
+  for (size_t i = 0; i < rows; i++) {
+    auto maybe_null = [&](TypeId type, const Value &value) {
+      return gen() % 10 == 0 ? ValueFactory::GetNullValueByType(type) : value;
+    };
+    table.push_back({maybe_null(TypeId::INTEGER, ValueFactory::GetIntegerValue(dist(gen))),
+                     maybe_null(TypeId::VARCHAR, ValueFactory::GetVarcharValue("s" + std::to_string(dist(gen) % 20))),
+                     maybe_null(TypeId::DECIMAL, ValueFactory::GetDecimalValue(dist(gen) / 4.0))});
+    RID rid;
+    EXPECT_TRUE(table_info->table_->InsertTuple(Tuple{table.back(), &schema}, &rid, txn));
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+  return table;
+}
+
+static auto RunQuery(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  EXPECT_TRUE(bustub->ExecuteSql(sql, writer));
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(ss, row);) {
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, ExternalSortSameAsInMemory) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto table = CreateTable(bustub.get(), 5000);
+
+  // ORDER BY c DESC, a, b
+  std::sort(table.begin(), table.end(), [](const std::vector<Value> &x, const std::vector<Value> &y) {
+    if (ValueLess(y[2], x[2]) || ValueLess(x[2], y[2])) {
+      return ValueLess(y[2], x[2]);
+    }
+    if (ValueLess(x[0], y[0]) || ValueLess(y[0], x[0])) {
+      return ValueLess(x[0], y[0]);
+    }
+    return ValueLess(x[1], y[1]);
+  });
+  std::vector<std::string> expected;
+  for (const auto &row : table) {
+    expected.push_back(row[0].ToString() + "\t" + row[1].ToString() + "\t" + row[2].ToString() + "\t");
+  }
+
+  // A budget of a few kilobytes makes runs of a few dozen tuples, and hundreds of runs take several merge passes.
+  for (const auto *threads : {"1", "4"}) {
+    RunQuery(bustub.get(), std::string("set execution_threads=") + threads + ";");
+    for (const auto *budget : {"4194304", "65536", "2048"}) {
+      RunQuery(bustub.get(), std::string("set sort_memory_budget=") + budget + ";");
+      EXPECT_EQ(expected, RunQuery(bustub.get(), "select a, b, c from t order by c desc, a, b;"))
+          << threads << " threads, budget " << budget;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, ParallelSortSameAsSerial) {
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  // The mock table is shuffled, and large enough to be sorted in several slices that are merged in parallel.
+  std::vector<std::string> expected;
+  for (int i = 99999; i >= 0; i--) {
+    expected.push_back(std::to_string(i) + "\t" + std::to_string(i * 100) + "\t");
+  }
+  for (const auto *threads : {"1", "3", "4"}) {
+    RunQuery(bustub.get(), std::string("set execution_threads=") + threads + ";");
+    for (const auto *budget : {"67108864", "262144"}) {
+      RunQuery(bustub.get(), std::string("set sort_memory_budget=") + budget + ";");
+      EXPECT_EQ(expected, RunQuery(bustub.get(), "select x, y from __mock_t2_100k order by y desc;"))
+          << threads << " threads, budget " << budget;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, DISABLED_SortThroughputBenchmark) {
+  const int rounds = 5;
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  RunQuery(bustub.get(), "set sort_memory_budget=67108864;");
+
+  for (const auto *threads : {"1", "4"}) {
+    RunQuery(bustub.get(), std::string("set execution_threads=") + threads + ";");
+    for (const auto *query : {"select x, y from __mock_t4_1m order by y desc;",
+                              "select x, y from __mock_t2_100k order by x;"}) {
+      size_t rows = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < rounds; i++) {
+        rows += RunQuery(bustub.get(), query).size();
+      }
+      auto ms =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      std::printf("%s threads %-50s %zu rows in %5ld ms, %.2f M rows/s\n", threads, query, rows,  // NOLINT
+                  static_cast<long>(ms), rows / 1000.0 / std::max<int64_t>(ms, 1));
+    }
+  }
+}
+
+}  // namespace bustub
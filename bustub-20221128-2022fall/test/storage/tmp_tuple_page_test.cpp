@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -19,7 +20,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -48,4 +49,40 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
 }
 
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, FillAndScanTest) {
+  TmpTuplePage page{};
+  page_id_t page_id = 15445;
+  page.Init(page_id, BUSTUB_PAGE_SIZE);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 32);
+  Schema schema(columns);
+
+  int num_tuples = 0;
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  while (true) {
+    std::vector<Value> values;
+    values.emplace_back(ValueFactory::GetIntegerValue(num_tuples));
+    values.emplace_back(ValueFactory::GetVarcharValue(std::string(num_tuples % 32, 'x')));
+    if (!page.Insert(Tuple(values, &schema), &tmp_tuple)) {
+      break;
+    }
+    ASSERT_EQ(page_id, tmp_tuple.GetPageId());
+    num_tuples++;
+  }
+  ASSERT_GT(num_tuples, 0);
+
+  // Tuples are laid out from the end of the page, so scanning up from the free space pointer sees the newest first.
+  uint32_t offset = page.GetFreeSpacePointer();
+  for (int i = num_tuples - 1; i >= 0; i--) {
+    Tuple tuple;
+    offset = page.Get(TmpTuple(page_id, offset), &tuple);
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(std::string(i % 32, 'x'), tuple.GetValue(&schema, 1).ToString());
+  }
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, offset);
+}
+
 }  // namespace bustub
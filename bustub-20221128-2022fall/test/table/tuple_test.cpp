@@ -11,16 +11,23 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +78,100 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, MoveTakesOverData) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}}};
+  Tuple tuple{{ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("seven")}, &schema};
+  const char *data = tuple.GetData();
+
+  Tuple moved{std::move(tuple)};
+  ASSERT_EQ(data, moved.GetData());
+  ASSERT_EQ(nullptr, tuple.GetData());  // NOLINT(bugprone-use-after-move)
+  Tuple assigned{};
+  assigned = std::move(moved);
+  ASSERT_EQ(data, assigned.GetData());
+  ASSERT_EQ("seven", assigned.GetValue(&schema, 1).ToString());
+
+  Value value = ValueFactory::GetVarcharValue("eight");
+  Value moved_value{std::move(value)};
+  ASSERT_EQ("eight", moved_value.ToString());
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, PageTupleViews) {
+  auto bustub = std::make_unique<BustubInstance>();
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}}};
+  auto *table = bustub->catalog_->CreateTable(txn, "t", schema)->table_.get();
+  std::vector<RID> rids(500);
+  for (int i = 0; i < 500; i++) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))}, &schema};
+    ASSERT_TRUE(table->InsertTuple(tuple, &rids[i], txn));
+  }
+  ASSERT_TRUE(table->MarkDelete(rids[3], txn));
+
+  std::vector<Tuple> tuples;
+  std::vector<std::unique_ptr<char[]>> copies;
+  for (auto page_id : table->GetPageIds()) {
+    copies.push_back(std::make_unique<char[]>(BUSTUB_PAGE_SIZE));
+    table->GetPageTupleViews(page_id, copies.back().get(), &tuples);
+  }
+  ASSERT_GT(copies.size(), 1);
+  ASSERT_EQ(499, tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    const int expected = i < 3 ? i : i + 1;
+    ASSERT_FALSE(tuples[i].IsAllocated());
+    ASSERT_EQ(rids[expected], tuples[i].GetRid());
+    ASSERT_EQ(expected, tuples[i].GetValue(&schema, 0).GetAs<int32_t>());
+    ASSERT_EQ(std::to_string(expected), tuples[i].GetValue(&schema, 1).ToString());
+  }
+
+  // A copy of a view is a view too, until it is materialized.
+  Tuple tuple = tuples[10];
+  ASSERT_EQ(tuples[10].GetData(), tuple.GetData());
+  tuple.Materialize();
+  ASSERT_TRUE(tuple.IsAllocated());
+  ASSERT_NE(tuples[10].GetData(), tuple.GetData());
+  copies.clear();
+  ASSERT_EQ(11, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, DISABLED_ScanThroughputBenchmark) {
+  // Every insert walks the table heap from its first page, so the table is kept small enough for the buffer pool and
+  // the queries are repeated instead.
+  const size_t rows = 15000;
+  const int rounds = 100;
+  auto bustub = std::make_unique<BustubInstance>();
+  auto *txn = bustub->txn_manager_->Begin();
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}, Column{"c", TypeId::INTEGER}}};
+  auto *table_info = bustub->catalog_->CreateTable(txn, "t", schema);
+  for (size_t i = 0; i < rows; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i % 97)),
+                              ValueFactory::GetIntegerValue(i % 1000)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple{values, &schema}, &rid, txn));
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+
+  std::stringstream ss;
+  SimpleStreamWriter writer(ss, true);
+  bustub->ExecuteSql("set execution_threads=1;", writer);
+  // A scan, a scan that materializes all columns into a breaker, and a hash join that builds on all rows.
+  for (const auto *query :
+       {"select count(*) from t where c < 500;", "select count(*) from (select * from t order by c);",
+        "select count(*) from t t1 inner join t t2 on t1.a = t2.a;"}) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      ss.str("");
+      bustub->ExecuteSql(query, writer);
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%6.2f ms per query: %s", static_cast<double>(ms) / rounds, ss.str().c_str());  // NOLINT
+  }
+}
+
 }  // namespace bustub